@@ -0,0 +1,263 @@
+/*
+ * async_switch.h
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ASYNC_SWITCH_H_
+#define ASYNC_SWITCH_H_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "integral_switch.h"
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>) && defined(USE_CPP_17_VARIANT)
+#include <coroutine>
+#define USE_CPP_20_COROUTINES
+#endif
+#endif
+
+#ifdef USE_CPP_20_COROUTINES
+
+namespace integral_switch {
+
+namespace detail {
+
+template <typename Awaitable>
+decltype(auto) get_awaiter(Awaitable &&awaitable) {
+    if constexpr (requires { std::forward<Awaitable>(awaitable).operator co_await(); }) {
+        return std::forward<Awaitable>(awaitable).operator co_await();
+    } else if constexpr (requires { operator co_await(std::forward<Awaitable>(awaitable)); }) {
+        return operator co_await(std::forward<Awaitable>(awaitable));
+    } else {
+        return std::forward<Awaitable>(awaitable);
+    }
+}
+
+template <typename Awaitable>
+using awaiter_t = std::decay_t<decltype(get_awaiter(std::declval<Awaitable>()))>;
+
+template <typename Awaitable>
+using await_result_t = decltype(std::declval<awaiter_t<Awaitable> &>().await_resume());
+
+// Maps the void, bool and coroutine_handle results of await_suspend() to the coroutine to resume.
+template <typename Awaiter, typename Promise>
+std::coroutine_handle<> suspend(Awaiter &awaiter, std::coroutine_handle<Promise> handle) {
+    using result = decltype(awaiter.await_suspend(handle));
+
+    if constexpr (std::is_void_v<result>) {
+        awaiter.await_suspend(handle);
+        return std::noop_coroutine();
+    } else if constexpr (std::is_same_v<result, bool>) {
+        return awaiter.await_suspend(handle) ? std::coroutine_handle<>(std::noop_coroutine())
+                                             : std::coroutine_handle<>(handle);
+    } else {
+        return awaiter.await_suspend(handle);
+    }
+}
+
+} // namespace detail
+
+// Awaits whichever of the awaitables is active. The awaiter of the active awaitable is kept in
+// place and every step of the await is dispatched on its index, so the awaitables need no common
+// base and nothing is allocated. Awaiting it results in the common type of their results.
+template <typename... Awaitables> class variant_awaitable {
+    using switch_type = make_integral_switch<detail::index_sequence_for<Awaitables...>>;
+    using awaiters = std::variant<detail::awaiter_t<Awaitables>...>;
+
+    template <typename F> static decltype(auto) dispatch(std::size_t i, F &&f) {
+        return switch_type::visit_unchecked(std::forward<F>(f), i);
+    }
+
+    std::variant<Awaitables...> awaitables_;
+
+  public:
+    using result_type = std::common_type_t<detail::await_result_t<Awaitables>...>;
+
+    class awaiter {
+        awaiters awaiters_;
+
+      public:
+        explicit awaiter(std::variant<Awaitables...> &&awaitables)
+            : awaiters_(dispatch(awaitables.index(), [&](auto i) {
+                  constexpr std::size_t I = decltype(i)::value;
+
+                  return awaiters(std::in_place_index<I>,
+                                  detail::get_awaiter(std::get<I>(std::move(awaitables))));
+              })) {}
+
+        bool await_ready() {
+            return dispatch(awaiters_.index(), [&](auto i) -> bool {
+                return std::get<decltype(i)::value>(awaiters_).await_ready();
+            });
+        }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) {
+            return dispatch(awaiters_.index(), [&](auto i) {
+                return detail::suspend(std::get<decltype(i)::value>(awaiters_), handle);
+            });
+        }
+
+        result_type await_resume() {
+            return dispatch(awaiters_.index(), [&](auto i) -> result_type {
+                return std::get<decltype(i)::value>(awaiters_).await_resume();
+            });
+        }
+    };
+
+    explicit variant_awaitable(std::variant<Awaitables...> &&awaitables)
+        : awaitables_(std::move(awaitables)) {}
+
+    awaiter operator co_await() && { return awaiter(std::move(awaitables_)); }
+};
+
+namespace detail {
+
+template <typename> struct variant_awaitable_of; // undefined
+
+template <typename... Ts> struct variant_awaitable_of<std::variant<Ts...>> {
+    using type = variant_awaitable<Ts...>;
+};
+
+} // namespace detail
+
+template <typename Switch, typename Visitor>
+using async_return_type = typename detail::variant_awaitable_of<
+    typename Switch::template variant_return_type<Visitor>>::type;
+
+// Like Switch::visit(), for visitors whose cases return awaitables, e.g. the tasks of coroutines.
+// The cases may return different awaitable types as long as their results have a common type.
+// The awaitable of the selected case is returned in place, wrapped in a variant_awaitable.
+template <typename Switch, typename Policy = typename miss_policy<Switch>::type,
+          typename Visitor, typename U>
+async_return_type<Switch, Visitor> visit_async(Visitor &&visitor, U &&value) {
+    return async_return_type<Switch, Visitor>(Switch::template visit_variant<Policy>(
+        std::forward<Visitor>(visitor), std::forward<U>(value)));
+}
+
+// Fixed size blocks for coroutine frames, e.g. those of the handlers of a dispatcher. Promise types
+// that derive from arena_allocated take their frames from the arena that is current on the thread
+// when the coroutine is created, see frame_arena::scope. Frames larger than a block, frames created
+// while all blocks are in use and frames created without a current arena use ::operator new. An
+// arena must outlive its frames and must only be used by one thread at a time.
+class frame_arena {
+    struct free_block {
+        free_block *next;
+    };
+
+    std::size_t block_size_;
+    unsigned char *blocks_;
+    free_block *free_ = nullptr;
+    std::size_t available_ = 0;
+
+    static frame_arena *&current() {
+        static thread_local frame_arena *arena = nullptr;
+        return arena;
+    }
+
+    friend struct arena_allocated;
+
+  public:
+    // Makes an arena current on this thread for the lifetime of the scope.
+    class scope {
+        frame_arena *previous_;
+
+      public:
+        explicit scope(frame_arena &arena) : previous_(current()) { current() = &arena; }
+
+        scope(const scope &) = delete;
+        scope &operator=(const scope &) = delete;
+
+        ~scope() { current() = previous_; }
+    };
+
+    frame_arena(std::size_t block_size, std::size_t blocks)
+        : block_size_((block_size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) *
+                      alignof(std::max_align_t)),
+          blocks_(static_cast<unsigned char *>(::operator new(block_size_ * blocks))) {
+        for (std::size_t i = blocks; i-- > 0;) {
+            deallocate(blocks_ + i * block_size_);
+        }
+    }
+
+    frame_arena(const frame_arena &) = delete;
+    frame_arena &operator=(const frame_arena &) = delete;
+
+    ~frame_arena() { ::operator delete(blocks_); }
+
+    std::size_t block_size() const { return block_size_; }
+
+    // Number of free blocks.
+    std::size_t available() const { return available_; }
+
+    // Returns nullptr if the size is larger than a block or no block is free.
+    void *allocate(std::size_t size) {
+        if (size > block_size_ || free_ == nullptr) {
+            return nullptr;
+        }
+
+        free_block *block = free_;
+
+        free_ = block->next;
+        --available_;
+        return block;
+    }
+
+    void deallocate(void *p) {
+        free_ = new (p) free_block{free_};
+        ++available_;
+    }
+};
+
+// A base for promise types whose coroutine frames come from the current frame_arena. Every frame
+// is preceded by the arena it was taken from, or nullptr.
+struct arena_allocated {
+    static constexpr std::size_t header_size = alignof(std::max_align_t);
+
+    static void *operator new(std::size_t size) {
+        frame_arena *arena = frame_arena::current();
+        void *p = arena != nullptr ? arena->allocate(size + header_size) : nullptr;
+
+        if (p == nullptr) {
+            arena = nullptr;
+            p = ::operator new(size + header_size);
+        }
+
+        *static_cast<frame_arena **>(p) = arena;
+        return static_cast<unsigned char *>(p) + header_size;
+    }
+
+    static void operator delete(void *frame) {
+        void *p = static_cast<unsigned char *>(frame) - header_size;
+        frame_arena *arena = *static_cast<frame_arena **>(p);
+
+        if (arena != nullptr) {
+            arena->deallocate(p);
+        } else {
+            ::operator delete(p);
+        }
+    }
+};
+
+} // namespace integral_switch
+
+#endif
+
+#endif
@@ -0,0 +1,257 @@
+/*
+ * batch_encoder.h
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BATCH_ENCODER_H_
+#define BATCH_ENCODER_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "integral_switch.h"
+
+namespace integral_switch {
+
+// Every record of a batch is a header followed by size bytes of payload. Both fields are in the
+// byte order of the host.
+struct batch_header {
+    std::uint32_t tag;
+    std::uint32_t size;
+};
+
+namespace detail {
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ < 5
+// libstdc++ has std::is_trivially_copyable from GCC 5 on.
+template <typename U>
+using is_trivially_copyable = std::integral_constant<bool, __has_trivial_copy(U)>;
+#else
+template <typename U> using is_trivially_copyable = std::is_trivially_copyable<U>;
+#endif
+
+// Messages with encoded_size(message) and encode(message, out) found by argument dependent lookup
+// are encoded with them. encode() writes exactly encoded_size(message) bytes to out and returns the
+// end of what it wrote. Other messages must be trivially copyable, and their payload is the message
+// itself, so that gather() can point at it instead of copying.
+template <typename U, typename = void> struct encodes_in_place : std::true_type {};
+
+template <typename U>
+struct encodes_in_place<U, decltype(static_cast<void>(encoded_size(std::declval<const U &>())))>
+    : std::false_type {};
+
+template <typename U, typename = void> struct has_encode : std::false_type {};
+
+template <typename U>
+struct has_encode<U, typename std::enable_if<std::is_same<
+                         char *, decltype(encode(std::declval<const U &>(),
+                                                 std::declval<char *>()))>::value>::type>
+    : std::true_type {};
+
+template <typename U> std::size_t payload_size(const U &message, std::false_type) {
+    static_assert(has_encode<U>::value,
+                  "messages with encoded_size() need encode(const U &, char *) returning char *");
+    return encoded_size(message);
+}
+
+template <typename U> std::size_t payload_size(const U &, std::true_type) {
+    static_assert(is_trivially_copyable<U>::value,
+                  "messages without encoded_size() and encode() must be trivially copyable");
+    return sizeof(U);
+}
+
+template <typename U> char *encode_payload(const U &message, char *out, std::false_type) {
+    return encode(message, out);
+}
+
+template <typename U> char *encode_payload(const U &message, char *out, std::true_type) {
+    std::memcpy(out, &message, sizeof(U));
+    return out + sizeof(U);
+}
+
+INTEGRAL_SWITCH_ALWAYS_INLINE char *write_batch_header(char *out, std::uint32_t tag,
+                                                       std::uint32_t size) {
+    const batch_header header{tag, size};
+
+    std::memcpy(out, &header, sizeof(header));
+    return out + sizeof(header);
+}
+
+struct encode_case {
+    const void *message;
+    char *out;
+
+    template <typename U> INTEGRAL_SWITCH_ALWAYS_INLINE char *operator()(type<U>) const {
+        return encode_payload(*static_cast<const U *>(message), out, encodes_in_place<U>{});
+    }
+};
+
+// Calls the visitor with the type and the payload of a record.
+template <typename Visitor> struct batch_record_visitor {
+    Visitor &visitor;
+    const char *payload;
+    std::size_t size;
+
+    template <typename U> INTEGRAL_SWITCH_ALWAYS_INLINE void operator()(type<U>) const {
+        visitor(type<U>{}, payload, size);
+    }
+};
+
+} // namespace detail
+
+// Encodes messages of the types Ts into one batch of records, each tagged with the position of the
+// type of its message in Ts. add() only records the message and its size, so the size of the batch
+// is known before anything is encoded, and encode() then writes all records in one pass to a
+// buffer of that size, dispatching on the tags through a variadic_switch. gather() writes the
+// batch as a list of iovec like buffers for writev() instead, which points at the payloads of
+// trivially copyable messages rather than copying them. The messages must stay alive and
+// unchanged until the batch is encoded. Apart from growing the list of messages, which reserve()
+// avoids, nothing is allocated.
+template <typename... Ts> class batch_encoder {
+    using tags = variadic_switch<Ts...>;
+
+    struct entry {
+        const void *message;
+        std::uint32_t tag;
+        std::uint32_t size;
+        bool in_place;
+    };
+
+    std::vector<entry> entries_;
+    std::size_t size_ = 0;
+    std::size_t scratch_size_ = 0;
+
+  public:
+    void reserve(std::size_t messages) { entries_.reserve(messages); }
+
+    // Adds a message to the batch. Its type must be one of Ts. The batch keeps a pointer to the
+    // message, so temporaries are rejected.
+    template <typename U> void add(const U &message) {
+        const std::size_t size = detail::payload_size(message, detail::encodes_in_place<U>{});
+        const bool in_place = detail::encodes_in_place<U>::value;
+
+        assert(size <= std::numeric_limits<std::uint32_t>::max());
+
+        entries_.push_back(entry{&message,
+                                 static_cast<std::uint32_t>(tags::template index_of<U>()),
+                                 static_cast<std::uint32_t>(size), in_place});
+        size_ += sizeof(batch_header) + size;
+        scratch_size_ += sizeof(batch_header) + (in_place ? 0 : size);
+    }
+
+    template <typename U> void add(const U &&) = delete;
+
+    // Forgets all messages but keeps the capacity of the list of messages.
+    void clear() {
+        entries_.clear();
+        size_ = 0;
+        scratch_size_ = 0;
+    }
+
+    std::size_t count() const { return entries_.size(); }
+
+    // The number of bytes of the encoded batch.
+    std::size_t size() const { return size_; }
+
+    // Writes size() bytes to out and returns their end.
+    char *encode(char *out) const {
+        for (const entry &e : entries_) {
+            out = detail::write_batch_header(out, e.tag, e.size);
+            out = tags::visit_unchecked(detail::encode_case{e.message, out}, e.tag);
+        }
+        return out;
+    }
+
+    // Appends the batch to a std::string or std::vector<char>, which is resized once.
+    template <typename Buffer> void encode_to(Buffer &buffer) const {
+        const std::size_t offset = buffer.size();
+
+        buffer.resize(offset + size_);
+        encode(&buffer[0] + offset);
+    }
+
+    // The number of bytes of scratch space and the most buffers that gather() needs.
+    std::size_t scratch_size() const { return scratch_size_; }
+
+    std::size_t max_buffers() const { return 2 * entries_.size(); }
+
+    // Writes the batch as buffers with the members iov_base and iov_len, e.g. struct iovec, and
+    // returns their number, which is at most max_buffers(). The headers and the payloads that are
+    // not trivially copyable are encoded to scratch, which must hold scratch_size() bytes; adjacent
+    // ones share a buffer. Callers split the buffers into calls of at most IOV_MAX.
+    template <typename Iovec> std::size_t gather(Iovec *buffers, char *scratch) const {
+        std::size_t n = 0;
+        char *first = scratch;
+
+        for (const entry &e : entries_) {
+            scratch = detail::write_batch_header(scratch, e.tag, e.size);
+
+            if (!e.in_place) {
+                scratch = tags::visit_unchecked(detail::encode_case{e.message, scratch}, e.tag);
+            } else if (e.size != 0) {
+                buffers[n].iov_base = first;
+                buffers[n].iov_len = static_cast<std::size_t>(scratch - first);
+                buffers[n + 1].iov_base = const_cast<void *>(e.message);
+                buffers[n + 1].iov_len = e.size;
+                n += 2;
+                first = scratch;
+            }
+        }
+
+        if (scratch != first) {
+            buffers[n].iov_base = first;
+            buffers[n].iov_len = static_cast<std::size_t>(scratch - first);
+            ++n;
+        }
+        return n;
+    }
+};
+
+// Calls visitor(type<U>{}, payload, size) for every whole record of a batch encoded by a
+// batch_encoder<Ts...>, in order, and returns the number of bytes of these records. A record that
+// is cut off at the end of the data is left for the next call. Tags that are not positions in Ts
+// are handled by the miss policy of variadic_switch<Ts...>.
+template <typename... Ts, typename Visitor>
+std::size_t decode_batch(const char *data, std::size_t size, Visitor &&visitor) {
+    std::size_t offset = 0;
+
+    while (size - offset >= sizeof(batch_header)) {
+        batch_header header;
+
+        std::memcpy(&header, data + offset, sizeof(header));
+
+        if (size - offset - sizeof(header) < header.size) {
+            break;
+        }
+
+        variadic_switch<Ts...>::visit(
+            detail::batch_record_visitor<Visitor>{visitor, data + offset + sizeof(header),
+                                                  header.size},
+            header.tag);
+        offset += sizeof(header) + header.size;
+    }
+    return offset;
+}
+
+} // namespace integral_switch
+
+#endif
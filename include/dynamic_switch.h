@@ -0,0 +1,184 @@
+/*
+ * dynamic_switch.h
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef DYNAMIC_SWITCH_H_
+#define DYNAMIC_SWITCH_H_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "integral_switch.h"
+
+// Size in bytes of the in-place storage of every handler of a dynamic_switch.
+#ifndef INTEGRAL_SWITCH_HANDLER_CAPACITY
+#define INTEGRAL_SWITCH_HANDLER_CAPACITY (2 * sizeof(void *))
+#endif
+
+namespace integral_switch {
+
+namespace detail {
+
+// Maps a key of a switch to its position among the keys, and any other value to the number of keys.
+template <typename T, T... v> struct key_index {
+    using positions = key_positions<T, make_index_sequence<sizeof...(v)>, v...>;
+
+    struct visitor {
+        template <T u> constexpr std::size_t operator()(std::integral_constant<T, u>) const {
+            return position_of<T, u>(positions{});
+        }
+    };
+
+    struct not_found {
+        constexpr std::size_t operator()(T) const { return sizeof...(v); }
+    };
+
+    template <typename Impl> static INTEGRAL_SWITCH_ALWAYS_INLINE std::size_t of(T key, Impl) {
+        return integral_switch<T, v...>::visit_or(visitor{}, key, not_found{});
+    }
+
+    // Large key sets already look up the position, so there is no need to dispatch through a table.
+    static INTEGRAL_SWITCH_ALWAYS_INLINE std::size_t of(T key, table_switch_impl<T, v...>) {
+        return table_switch_impl<T, v...>::index_of(to_underlying(key));
+    }
+
+    static INTEGRAL_SWITCH_ALWAYS_INLINE std::size_t of(T key) {
+        return of(key, switch_impl_t<T, v...>{});
+    }
+};
+
+// A callable stored in place, called through a single function pointer. Slots that hold no
+// callable call the miss policy with the key instead.
+template <typename Signature, typename T, typename Policy> class handler_slot; // undefined
+
+template <typename R, typename... Args, typename T, typename Policy>
+class handler_slot<R(Args...), T, Policy> {
+    using invoke_type = R (*)(void *, T, Args &&...);
+    using destroy_type = void (*)(void *);
+
+    template <typename F> static R invoke_handler(void *storage, T, Args &&... args) {
+        return (*static_cast<F *>(storage))(std::forward<Args>(args)...);
+    }
+
+    template <typename F> static void destroy_handler(void *storage) {
+        static_cast<F *>(storage)->~F();
+    }
+
+    static R invoke_unbound(void *, T key, Args &&...) {
+        return Policy::template miss<R>(key);
+    }
+
+    static void destroy_unbound(void *) {}
+
+    invoke_type invoke_;
+    destroy_type destroy_;
+    alignas(void *) unsigned char storage_[INTEGRAL_SWITCH_HANDLER_CAPACITY];
+
+  public:
+    handler_slot() : invoke_(&invoke_unbound), destroy_(&destroy_unbound) {}
+
+    handler_slot(const handler_slot &) = delete;
+    handler_slot &operator=(const handler_slot &) = delete;
+
+    ~handler_slot() { destroy_(storage_); }
+
+    template <typename F> void bind(F &&handler) {
+        using stored_type = typename std::decay<F>::type;
+
+        static_assert(sizeof(stored_type) <= sizeof(storage_),
+                      "handler is larger than INTEGRAL_SWITCH_HANDLER_CAPACITY");
+        static_assert(alignof(stored_type) <= alignof(void *), "handler is over-aligned");
+
+        // Leaves the slot unbound rather than pointing at the destroyed handler if the constructor
+        // of the new one throws.
+        destroy_(storage_);
+        invoke_ = &invoke_unbound;
+        destroy_ = &destroy_unbound;
+        new (storage_) stored_type(std::forward<F>(handler));
+        invoke_ = &invoke_handler<stored_type>;
+        destroy_ = &destroy_handler<stored_type>;
+    }
+
+    void unbind() {
+        destroy_(storage_);
+        invoke_ = &invoke_unbound;
+        destroy_ = &destroy_unbound;
+    }
+
+    bool bound() const { return destroy_ != &destroy_unbound; }
+
+    INTEGRAL_SWITCH_ALWAYS_INLINE R operator()(T key, Args &&... args) {
+        return invoke_(storage_, key, std::forward<Args>(args)...);
+    }
+};
+
+} // namespace detail
+
+// A switch over a compile-time key set whose handlers are bound at runtime, e.g. by plugins. The
+// handlers live in place in a table with one slot per key, so neither binding nor visiting
+// allocates, and visit() is a key lookup followed by one indirect call. Handlers must fit into
+// INTEGRAL_SWITCH_HANDLER_CAPACITY bytes. Binding is not synchronised with visit().
+template <typename Signature, typename T, T... v> class dynamic_switch; // undefined
+
+template <typename R, typename... Args, typename T, T... v>
+class dynamic_switch<R(Args...), T, v...> {
+    using index = detail::key_index<T, v...>;
+    using slot = detail::handler_slot<R(Args...), T, typename miss_policy<dynamic_switch>::type>;
+
+    static constexpr std::size_t size = sizeof...(v);
+
+    // The slot after the last key catches the values that are not keys.
+    alignas(INTEGRAL_SWITCH_CACHE_LINE_SIZE) slot slots_[size + 1];
+
+  public:
+    dynamic_switch() = default;
+
+    dynamic_switch(const dynamic_switch &) = delete;
+    dynamic_switch &operator=(const dynamic_switch &) = delete;
+
+    template <T u, typename F> void bind(F &&handler) {
+        slots_[detail::position_of<T, u>(typename index::positions{})].bind(
+            std::forward<F>(handler));
+    }
+
+    // Returns false if the key is not one of the keys of the switch.
+    template <typename F> bool bind(T key, F &&handler) {
+        const std::size_t i = index::of(key);
+
+        if (i == size) {
+            return false;
+        }
+
+        slots_[i].bind(std::forward<F>(handler));
+        return true;
+    }
+
+    void unbind(T key) { slots_[index::of(key)].unbind(); }
+
+    bool bound(T key) const { return slots_[index::of(key)].bound(); }
+
+    // Calls the handler bound to the key, or the miss policy if there is none.
+    INTEGRAL_SWITCH_ALWAYS_INLINE R visit(T key, Args... args) {
+        return slots_[index::of(key)](key, std::forward<Args>(args)...);
+    }
+};
+
+} // namespace integral_switch
+
+#endif
@@ -0,0 +1,259 @@
+/*
+ * enum_switch.h
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ENUM_SWITCH_H_
+#define ENUM_SWITCH_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "string_switch.h"
+
+// The names of enumerators are read from the signature of a function template instantiated with
+// the enumerator, which needs C++17 and a compiler whose signatures spell it out.
+#if defined(__has_include) && __cplusplus >= 201703L
+#if __has_include(<string_view>) && __has_include(<optional>) &&                                 \
+    (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 9) || defined(_MSC_VER))
+#include <array>
+#include <optional>
+#include <string_view>
+#define USE_CPP_17_ENUM_NAMES
+#endif
+#endif
+
+// The default range of values that are probed for enumerators.
+#ifndef INTEGRAL_SWITCH_ENUM_MIN
+#define INTEGRAL_SWITCH_ENUM_MIN -128
+#endif
+
+#ifndef INTEGRAL_SWITCH_ENUM_MAX
+#define INTEGRAL_SWITCH_ENUM_MAX 511
+#endif
+
+#ifdef USE_CPP_17_ENUM_NAMES
+
+namespace integral_switch {
+
+// The range of values [min, max] that are probed for enumerators of E, clamped to the range of its
+// underlying type. Specialise it for enums with values outside of the default range, and for
+// unscoped enums without a fixed underlying type, whose values must not leave the range of their
+// enumerators.
+template <typename E> struct enum_range {
+    static constexpr long long min = INTEGRAL_SWITCH_ENUM_MIN;
+    static constexpr long long max = INTEGRAL_SWITCH_ENUM_MAX;
+};
+
+namespace detail {
+
+template <typename E, E V> constexpr const char *enum_signature() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return __FUNCSIG__;
+#else
+    return __PRETTY_FUNCTION__;
+#endif
+}
+
+template <typename C> constexpr bool is_identifier_char(C c) {
+    return c == '_' || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+// The signature ends with the value, e.g. "[with E = color; E V = color::red]", or with a cast of
+// the value, "(color)3", if it is not an enumerator. Returns the name after the last scope, or an
+// empty name.
+constexpr std::string_view enumerator_name(std::string_view signature) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    signature.remove_suffix(sizeof(">(void)") - 1);
+#else
+    signature.remove_suffix(1);
+#endif
+
+    std::size_t i = signature.size();
+
+    while (i > 0 && is_identifier_char(signature[i - 1])) {
+        --i;
+    }
+
+    const std::string_view name = signature.substr(i);
+
+    return name.empty() || (name[0] >= '0' && name[0] <= '9') ? std::string_view() : name;
+}
+
+template <typename E, E V>
+constexpr std::string_view enum_name_of = enumerator_name(enum_signature<E, V>());
+
+// The range of values probed for enumerators of E.
+template <typename E> struct enum_probe_range {
+    using underlying_type = std::underlying_type_t<E>;
+
+    static constexpr long long min =
+        std::is_unsigned<underlying_type>::value && enum_range<E>::min < 0
+            ? 0
+            : std::max<long long>(enum_range<E>::min, std::numeric_limits<underlying_type>::min());
+
+    static constexpr long long max =
+        enum_range<E>::max > 0 &&
+                static_cast<unsigned long long>(enum_range<E>::max) >
+                    static_cast<unsigned long long>(std::numeric_limits<underlying_type>::max())
+            ? static_cast<long long>(std::numeric_limits<underlying_type>::max())
+            : enum_range<E>::max;
+
+    static_assert(min <= max, "the enum_range of an enum must not be empty");
+
+    static constexpr std::size_t size = static_cast<std::size_t>(max - min) + 1;
+
+    static constexpr E value_at(std::size_t offset) {
+        return static_cast<E>(static_cast<underlying_type>(min + static_cast<long long>(offset)));
+    }
+};
+
+template <typename E, std::size_t... Is>
+constexpr std::array<std::string_view, sizeof...(Is)> probe_enum(index_sequence<Is...>) {
+    return {{enum_name_of<E, enum_probe_range<E>::value_at(Is)>...}};
+}
+
+template <std::size_t N>
+constexpr std::size_t count_names(const std::array<std::string_view, N> &names) {
+    std::size_t n = 0;
+
+    for (const auto &name : names) {
+        n += name.empty() ? 0 : 1;
+    }
+    return n;
+}
+
+// The enumerators of E found in its enum_range, in ascending order of their values.
+template <typename E> struct enum_info {
+    using range = enum_probe_range<E>;
+
+    static constexpr std::array<std::string_view, range::size> probed =
+        probe_enum<E>(make_index_sequence<range::size>{});
+
+    static constexpr std::size_t count = count_names(probed);
+
+    static_assert(count < 65536, "too many enumerators");
+
+    static constexpr std::array<E, count> values = [] {
+        std::array<E, count> values{};
+        std::size_t n = 0;
+
+        for (std::size_t i = 0; i < range::size; ++i) {
+            if (!probed[i].empty()) {
+                values[n++] = range::value_at(i);
+            }
+        }
+        return values;
+    }();
+
+    static constexpr std::array<std::string_view, count> names = [] {
+        std::array<std::string_view, count> names{};
+        std::size_t n = 0;
+
+        for (std::size_t i = 0; i < range::size; ++i) {
+            if (!probed[i].empty()) {
+                names[n++] = probed[i];
+            }
+        }
+        return names;
+    }();
+
+    // The position of the enumerator of every value in the range, or count.
+    static constexpr std::array<std::uint16_t, range::size> positions = [] {
+        std::array<std::uint16_t, range::size> positions{};
+        std::size_t n = 0;
+
+        for (std::size_t i = 0; i < range::size; ++i) {
+            positions[i] = static_cast<std::uint16_t>(probed[i].empty() ? count : n++);
+        }
+        return positions;
+    }();
+
+    static constexpr std::size_t position_of(E value) {
+        using underlying_type = typename range::underlying_type;
+
+        const auto offset = key_offset(static_cast<underlying_type>(value),
+                                       static_cast<underlying_type>(range::min));
+
+        return offset < range::size ? positions[static_cast<std::size_t>(offset)] : count;
+    }
+};
+
+template <typename E, typename Seq = make_index_sequence<enum_info<E>::count>>
+struct enum_switch_of; // undefined
+
+template <typename E, std::size_t... Is> struct enum_switch_of<E, index_sequence<Is...>> {
+    using type = integral_switch<E, enum_info<E>::values[Is]...>;
+};
+
+template <typename E, std::size_t I,
+          typename Seq = make_index_sequence<enum_info<E>::names[I].size()>>
+struct enum_name_key; // undefined
+
+template <typename E, std::size_t I, std::size_t... Is>
+struct enum_name_key<E, I, index_sequence<Is...>> {
+    using type = string_key<enum_info<E>::names[I][Is]...>;
+};
+
+template <typename E, typename Seq = make_index_sequence<enum_info<E>::count>>
+struct enum_name_switch; // undefined
+
+template <typename E, std::size_t... Is> struct enum_name_switch<E, index_sequence<Is...>> {
+    using type = basic_string_switch<typename enum_name_key<E, Is>::type...>;
+};
+
+} // namespace detail
+
+// An integral_switch over every enumerator of E, which are discovered by probing the values of
+// enum_range<E>. The keys are in ascending order, so that enums with more than
+// INTEGRAL_SWITCH_TABLE_THRESHOLD enumerators are dispatched through a flat table.
+template <typename E> using enum_switch = typename detail::enum_switch_of<E>::type;
+
+// The number of enumerators of E.
+template <typename E> constexpr std::size_t enum_count() { return detail::enum_info<E>::count; }
+
+// The enumerators of E in ascending order.
+template <typename E> constexpr const std::array<E, detail::enum_info<E>::count> &enum_values() {
+    return detail::enum_info<E>::values;
+}
+
+// The name of an enumerator, without its scope, or an empty string if the value has none. Looked
+// up by the offset of the value in enum_range<E>.
+template <typename E> constexpr std::string_view to_string(E value) {
+    using info = detail::enum_info<E>;
+
+    const std::size_t i = info::position_of(value);
+
+    return i < info::count ? info::names[i] : std::string_view();
+}
+
+// The enumerator with the name, found through a basic_string_switch over the names.
+template <typename E> std::optional<E> from_string(std::string_view name) {
+    using info = detail::enum_info<E>;
+
+    const std::size_t i = detail::enum_name_switch<E>::type::find(name);
+
+    return i < info::count ? std::optional<E>(info::values[i]) : std::nullopt;
+}
+
+} // namespace integral_switch
+
+#endif
+
+#endif
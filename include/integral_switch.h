@@ -19,8 +19,21 @@
 #ifndef INTEGRAL_SWITCH_H_
 #define INTEGRAL_SWITCH_H_
 
+#include <cassert>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
 #include <tuple>
 #include <type_traits>
+#include <utility>
+
+#if defined(__has_include) && __cplusplus >= 201703L
+#if __has_include(<variant>)
+#include <variant>
+#define USE_CPP_17_VARIANT
+#endif
+#endif
 
 namespace integral_switch {
 
@@ -32,6 +45,15 @@ namespace integral_switch {
 #define USE_CPP_14_INTEGER_SEQUENCE
 #endif
 
+#if defined(INTEGRAL_SWITCH_FOLD_BACKEND) && defined(__cpp_fold_expressions) &&                    \
+    defined(__cpp_if_constexpr)
+#define USE_CPP_17_FOLD_BACKEND
+#endif
+
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define USE_CPP_EXCEPTIONS
+#endif
+
 #ifndef __has_attribute
 #define __has_attribute(x) 0
 #endif
@@ -44,8 +66,81 @@ namespace integral_switch {
 #define INTEGRAL_SWITCH_ALWAYS_INLINE inline
 #endif
 
+#if __has_attribute(noinline) || defined(__GNUC__)
+#define INTEGRAL_SWITCH_NOINLINE __attribute__((__noinline__))
+#elif defined(_MSC_VER)
+#define INTEGRAL_SWITCH_NOINLINE __declspec(noinline)
+#else
+#define INTEGRAL_SWITCH_NOINLINE
+#endif
+
+#if __has_attribute(cold) || defined(__GNUC__)
+#define INTEGRAL_SWITCH_COLD __attribute__((__cold__))
+#else
+#define INTEGRAL_SWITCH_COLD
+#endif
+
+#if defined(__GNUC__)
+#define INTEGRAL_SWITCH_UNREACHABLE() __builtin_unreachable()
+#elif defined(_MSC_VER)
+#define INTEGRAL_SWITCH_UNREACHABLE() __assume(false)
+#else
+#define INTEGRAL_SWITCH_UNREACHABLE() std::abort()
+#endif
+
+// Number of case labels emitted per switch statement by gen-integral-switch.py.
+#define INTEGRAL_SWITCH_CHUNK_WIDTH 32
+
+// Larger key sets are dispatched through flat tables when their keys are in ascending order.
+#ifndef INTEGRAL_SWITCH_TABLE_THRESHOLD
+#define INTEGRAL_SWITCH_TABLE_THRESHOLD 256
+#endif
+
+// Alignment of data that threads must not share a cache line for, e.g. the handler table of a
+// dynamic_switch and the counters of concurrent switches.
+#ifndef INTEGRAL_SWITCH_CACHE_LINE_SIZE
+#define INTEGRAL_SWITCH_CACHE_LINE_SIZE 64
+#endif
+
 template <typename T> struct type {};
 
+// Policies for values that are not keys of a switch. A policy is chosen per call, e.g.
+// Switch::visit<abort_on_miss>(visitor, value), or per switch by specialising miss_policy. Custom
+// policies provide the same static member function template miss<Ret>(value).
+
+// Throws std::invalid_argument, or aborts when exceptions are disabled.
+struct throw_on_miss {
+    template <typename Ret, typename T> static Ret miss(T &&) {
+#ifdef USE_CPP_EXCEPTIONS
+        throw std::invalid_argument("value");
+#else
+        std::abort();
+#endif
+    }
+};
+
+struct abort_on_miss {
+    template <typename Ret, typename T> static Ret miss(T &&) { std::abort(); }
+};
+
+// Lets the compiler drop the range check of a switch. Misses are only diagnosed in debug builds.
+struct unreachable_on_miss {
+    template <typename Ret, typename T>
+#ifdef USE_CPP_14_CONSTEXPR
+    static constexpr Ret miss(T &&)
+#else
+    static Ret miss(T &&)
+#endif
+    {
+        assert(!"integral_switch: value is not a key of the switch");
+        INTEGRAL_SWITCH_UNREACHABLE();
+    }
+};
+
+template <typename Switch> struct miss_policy {
+    using type = throw_on_miss;
+};
+
 namespace detail {
 
 // Some helper utilities
@@ -88,11 +183,45 @@ template <std::size_t I> using make_index_sequence = typename make_index_sequenc
 template <typename... T> using index_sequence_for = make_index_sequence<sizeof...(T)>;
 #endif
 
+// Derives from indexed_type<T, I> for the I-th type T, so that the type at a position and the
+// position of a type are deduced from a single base class, instead of by recursing over the types
+// like std::tuple_element does.
+template <typename T, std::size_t I> struct indexed_type {
+    using type = T;
+};
+
+template <typename Seq, typename... Ts> struct indexed_types; // undefined
+
+template <std::size_t... Is, typename... Ts>
+struct indexed_types<index_sequence<Is...>, Ts...> : indexed_type<Ts, Is>... {};
+
+template <typename... Ts>
+using indexed_types_for = indexed_types<index_sequence_for<Ts...>, Ts...>;
+
+template <std::size_t I, typename T> indexed_type<T, I> select_type(const indexed_type<T, I> *);
+
+// Deduction fails when U is not one of the types, or is more than one of them.
+template <typename U, std::size_t I> constexpr std::size_t find_type(const indexed_type<U, I> *) {
+    return I;
+}
+
+template <typename U> constexpr std::size_t find_type(const void *) { return std::size_t(-1); }
+
+template <std::size_t I, typename... Ts>
+using type_at =
+    typename decltype(select_type<I>(static_cast<const indexed_types_for<Ts...> *>(nullptr)))::type;
+
+template <typename U, typename... Ts> struct type_index {
+    static constexpr std::size_t value =
+        find_type<U>(static_cast<const indexed_types_for<Ts...> *>(nullptr));
+
+    static_assert(value < sizeof...(Ts), "the type must occur exactly once in the type list");
+};
+
 template <typename Visitor, typename... Ts> struct visitor_wrapper {
     Visitor &&visitor;
 
-    template <std::size_t I>
-    using get_type_at = typename std::tuple_element<I, std::tuple<Ts...>>::type;
+    template <std::size_t I> using get_type_at = type_at<I, Ts...>;
 
     template <std::size_t I>
     INTEGRAL_SWITCH_ALWAYS_INLINE constexpr decltype(visitor(type<get_type_at<I>>{}))
@@ -101,79 +230,204 @@ template <typename Visitor, typename... Ts> struct visitor_wrapper {
     }
 };
 
-template <typename...> struct integral_switch_impl; // undefined
+template <bool... Bs> using any = std::integral_constant<bool, !all<!Bs...>::value>;
 
-template <> struct integral_switch_impl<> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&, T &&) {
-        throw std::invalid_argument("value");
+template <typename Ret, typename Visitor, typename K> struct outlined_case {
+    static INTEGRAL_SWITCH_NOINLINE constexpr Ret call(Visitor &visitor) { return visitor(K{}); }
+};
+
+template <typename Ret, typename Visitor, typename K> struct cold_case {
+    static INTEGRAL_SWITCH_NOINLINE INTEGRAL_SWITCH_COLD constexpr Ret call(Visitor &visitor) {
+        return visitor(K{});
+    }
+};
+
+// Calls every case of the visitor through a function of its own, so that the switch only inlines a
+// call per case into its caller. Cases whose argument type is one of Cold are also marked cold.
+template <typename Visitor, typename... Cold> struct outlined_visitor {
+    Visitor &&visitor;
+
+    using visitor_type = typename std::remove_reference<Visitor>::type;
+
+    template <typename K, typename Ret = decltype(std::declval<visitor_type &>()(K{}))>
+    INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret operator()(K) const {
+        return std::conditional<any<std::is_same<K, Cold>::value...>::value,
+                                cold_case<Ret, visitor_type, K>,
+                                outlined_case<Ret, visitor_type, K>>::type::call(visitor);
+    }
+};
+
+// Converts the result of every case to R, so that cases with different result types can share
+// one switch.
+template <typename R, typename Visitor> struct converting_visitor {
+    Visitor &&visitor;
+
+    template <typename K> INTEGRAL_SWITCH_ALWAYS_INLINE constexpr R operator()(K key) const {
+        return static_cast<R>(visitor(key));
+    }
+};
+
+template <typename Visitor, typename K, typename Signature> struct resolved_case; // undefined
+
+// The function that resolve() returns for the key K.
+template <typename Visitor, typename K, typename Ret, typename... Args>
+struct resolved_case<Visitor, K, Ret(Args...)> {
+    static Ret call(Args... args) { return Visitor{}(K{}, std::forward<Args>(args)...); }
+};
+
+template <typename Visitor, typename Signature> struct resolve_visitor {
+    template <typename K> INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Signature *operator()(K) const {
+        return &resolved_case<Visitor, K, Signature>::call;
+    }
+};
+
+template <typename Visitor, typename Signature, typename... Ts> struct resolve_type_visitor {
+    template <std::size_t I>
+    INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Signature *
+    operator()(std::integral_constant<std::size_t, I>) const {
+        return &resolved_case<Visitor, type<type_at<I, Ts...>>, Signature>::call;
+    }
+};
+
+template <typename... Ts> struct type_list {};
+
+// Removes repeated types from Ts and appends the remaining ones to Result, keeping the order.
+template <typename Result, typename... Ts> struct unique_types {
+    using type = Result;
+};
+
+template <typename... Us, typename T, typename... Ts>
+struct unique_types<type_list<Us...>, T, Ts...>
+    : unique_types<typename std::conditional<any<std::is_same<T, Us>::value...>::value,
+                                             type_list<Us...>, type_list<Us..., T>>::type,
+                   Ts...> {};
+
+#ifdef USE_CPP_17_VARIANT
+template <typename> struct variant_of; // undefined
+
+template <typename... Ts> struct variant_of<type_list<Ts...>> {
+    using type = std::variant<Ts...>;
+};
+
+template <typename R, typename U> struct variant_index; // undefined
+
+template <typename... Ts, typename U>
+struct variant_index<std::variant<Ts...>, U> : type_index<U, Ts...> {};
+
+// Constructs the alternative of the variant R whose type is the result type of the case, rather
+// than converting the result to R, which may pick another alternative that it converts to.
+template <typename R, typename Visitor> struct variant_visitor {
+    Visitor &&visitor;
+
+    template <typename K> INTEGRAL_SWITCH_ALWAYS_INLINE constexpr R operator()(K key) const {
+        using result = decltype(std::declval<Visitor>()(key));
+
+        return R(std::in_place_index<variant_index<R, result>::value>, visitor(key));
     }
+};
+#endif
+
+template <typename T, T u, std::size_t I> struct key_position {};
+
+// Derives from key_position<T, v, I> for the I-th key v, so that the position of a key is deduced
+// by position_of() in a single step instead of a search over the keys.
+template <typename T, typename Seq, T... v> struct key_positions; // undefined
+
+template <typename T, std::size_t... Is, T... v>
+struct key_positions<T, index_sequence<Is...>, v...> : key_position<T, v, Is>... {};
+
+template <typename T, T u, std::size_t I>
+constexpr std::size_t position_of(const key_position<T, u, I> &) {
+    return I;
+}
+
+template <typename T, T... v> struct key_array {
+    static constexpr T values[sizeof...(v)] = {v...};
+};
 
-    template <typename Ret, typename Visitor, typename T, typename U>
+template <typename T, T... v> constexpr T key_array<T, v...>::values[sizeof...(v)];
+
+// A miss handler is called with the unmatched value when no case label matches it.
+template <typename Ret, typename Policy> struct policy_on_miss {
+    template <typename T>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&, T &&,
-                                                                        U &&default_ret)
+    constexpr Ret operator()(T &&value) const
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&, T &&, U &&default_ret)
+    Ret operator()(T &&value) const
 #endif
     {
+        return Policy::template miss<Ret>(std::forward<T>(value));
+    }
+};
+
+template <typename Ret, typename U> struct return_on_miss {
+    U &&default_ret;
+
+    template <typename T> constexpr Ret operator()(T &&) const {
         return std::forward<U>(default_ret);
     }
 };
 
-template <typename IHead0> struct integral_switch_impl<IHead0> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
+// Calls the fallback with the unmatched value, so that nothing is constructed unless it misses.
+template <typename Ret, typename F> struct call_on_miss {
+    F &&fallback;
+
+    template <typename T> constexpr Ret operator()(T &&value) const {
+        return std::forward<F>(fallback)(std::forward<T>(value));
+    }
+};
+
+template <typename Ret> struct error_on_miss {
+    std::error_code &ec;
+
+    template <typename T> Ret operator()(T &&) const {
+        ec = std::make_error_code(std::errc::invalid_argument);
+        return Ret();
     }
+};
+
+// The generated switch statements are not needed when fold_switch_impl replaces them.
+#ifndef USE_CPP_17_FOLD_BACKEND
+
+template <typename...> struct integral_switch_impl; // undefined
 
-    template <typename Ret, typename Visitor, typename T, typename U>
+template <> struct integral_switch_impl<> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&, T &&value, Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&, T &&value, Miss &&miss)
 #endif
     {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
-        }
+        return miss(std::forward<T>(value));
     }
 };
 
-template <typename IHead0, typename IHead1> struct integral_switch_impl<IHead0, IHead1> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
+template <typename IHead0> struct integral_switch_impl<IHead0> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
+#ifdef USE_CPP_14_CONSTEXPR
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
+#else
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
+#endif
+    {
         switch (value) {
         case IHead0::value:
             return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
         default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
+            return miss(std::forward<T>(value));
         }
     }
+};
 
-    template <typename Ret, typename Visitor, typename T, typename U>
+template <typename IHead0, typename IHead1> struct integral_switch_impl<IHead0, IHead1> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -182,37 +436,19 @@ template <typename IHead0, typename IHead1> struct integral_switch_impl<IHead0,
         case IHead1::value:
             return visitor(IHead1{});
         default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return miss(std::forward<T>(value));
         }
     }
 };
 
 template <typename IHead0, typename IHead1, typename IHead2>
 struct integral_switch_impl<IHead0, IHead1, IHead2> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
-    }
-
-    template <typename Ret, typename Visitor, typename T, typename U>
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -223,39 +459,19 @@ struct integral_switch_impl<IHead0, IHead1, IHead2> {
         case IHead2::value:
             return visitor(IHead2{});
         default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return miss(std::forward<T>(value));
         }
     }
 };
 
 template <typename IHead0, typename IHead1, typename IHead2, typename IHead3>
 struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
-    }
-
-    template <typename Ret, typename Visitor, typename T, typename U>
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -268,41 +484,19 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3> {
         case IHead3::value:
             return visitor(IHead3{});
         default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return miss(std::forward<T>(value));
         }
     }
 };
 
 template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4>
 struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
-    }
-
-    template <typename Ret, typename Visitor, typename T, typename U>
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -317,9 +511,7 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4> {
         case IHead4::value:
             return visitor(IHead4{});
         default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return miss(std::forward<T>(value));
         }
     }
 };
@@ -327,8 +519,14 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4> {
 template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
           typename IHead5>
 struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
+#ifdef USE_CPP_14_CONSTEXPR
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
+#else
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
+#endif
+    {
         switch (value) {
         case IHead0::value:
             return visitor(IHead0{});
@@ -343,18 +541,20 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5> {
         case IHead5::value:
             return visitor(IHead5{});
         default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
+            return miss(std::forward<T>(value));
         }
     }
+};
 
-    template <typename Ret, typename Visitor, typename T, typename U>
+template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
+          typename IHead5, typename IHead6>
+struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -370,19 +570,25 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5> {
             return visitor(IHead4{});
         case IHead5::value:
             return visitor(IHead5{});
+        case IHead6::value:
+            return visitor(IHead6{});
         default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return miss(std::forward<T>(value));
         }
     }
 };
 
 template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
-          typename IHead5, typename IHead6>
-struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
+          typename IHead5, typename IHead6, typename IHead7>
+struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
+#ifdef USE_CPP_14_CONSTEXPR
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
+#else
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
+#endif
+    {
         switch (value) {
         case IHead0::value:
             return visitor(IHead0{});
@@ -398,19 +604,24 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead5{});
         case IHead6::value:
             return visitor(IHead6{});
+        case IHead7::value:
+            return visitor(IHead7{});
         default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
+            return miss(std::forward<T>(value));
         }
     }
+};
 
-    template <typename Ret, typename Visitor, typename T, typename U>
+template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
+          typename IHead5, typename IHead6, typename IHead7, typename IHead8>
+struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7,
+                            IHead8> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -428,19 +639,28 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead5{});
         case IHead6::value:
             return visitor(IHead6{});
+        case IHead7::value:
+            return visitor(IHead7{});
+        case IHead8::value:
+            return visitor(IHead8{});
         default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return miss(std::forward<T>(value));
         }
     }
 };
 
 template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
-          typename IHead5, typename IHead6, typename IHead7>
-struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
+          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9>
+struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
+                            IHead9> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
+#ifdef USE_CPP_14_CONSTEXPR
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
+#else
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
+#endif
+    {
         switch (value) {
         case IHead0::value:
             return visitor(IHead0{});
@@ -458,19 +678,27 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead6{});
         case IHead7::value:
             return visitor(IHead7{});
+        case IHead8::value:
+            return visitor(IHead8{});
+        case IHead9::value:
+            return visitor(IHead9{});
         default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
+            return miss(std::forward<T>(value));
         }
     }
+};
 
-    template <typename Ret, typename Visitor, typename T, typename U>
+template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
+          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
+          typename IHead10>
+struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
+                            IHead9, IHead10> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -490,20 +718,31 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead6{});
         case IHead7::value:
             return visitor(IHead7{});
+        case IHead8::value:
+            return visitor(IHead8{});
+        case IHead9::value:
+            return visitor(IHead9{});
+        case IHead10::value:
+            return visitor(IHead10{});
         default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return miss(std::forward<T>(value));
         }
     }
 };
 
 template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
-          typename IHead5, typename IHead6, typename IHead7, typename IHead8>
-struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7,
-                            IHead8> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
+          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
+          typename IHead10, typename IHead11>
+struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
+                            IHead9, IHead10, IHead11> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
+#ifdef USE_CPP_14_CONSTEXPR
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
+#else
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
+#endif
+    {
         switch (value) {
         case IHead0::value:
             return visitor(IHead0{});
@@ -523,1254 +762,29 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead7{});
         case IHead8::value:
             return visitor(IHead8{});
+        case IHead9::value:
+            return visitor(IHead9{});
+        case IHead10::value:
+            return visitor(IHead10{});
+        case IHead11::value:
+            return visitor(IHead11{});
         default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
+            return miss(std::forward<T>(value));
         }
     }
+};
 
-    template <typename Ret, typename Visitor, typename T, typename U>
+template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
+          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
+          typename IHead10, typename IHead11, typename IHead12>
+struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
+                            IHead9, IHead10, IHead11, IHead12> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
-#endif
-    {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
-        }
-    }
-};
-
-template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
-          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9>
-struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
-                            IHead9> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
-    }
-
-    template <typename Ret, typename Visitor, typename T, typename U>
-#ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
-#else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
-#endif
-    {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
-        }
-    }
-};
-
-template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
-          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
-          typename IHead10>
-struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
-                            IHead9, IHead10> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
-    }
-
-    template <typename Ret, typename Visitor, typename T, typename U>
-#ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
-#else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
-#endif
-    {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
-        }
-    }
-};
-
-template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
-          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
-          typename IHead10, typename IHead11>
-struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
-                            IHead9, IHead10, IHead11> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
-    }
-
-    template <typename Ret, typename Visitor, typename T, typename U>
-#ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
-#else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
-#endif
-    {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
-        }
-    }
-};
-
-template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
-          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
-          typename IHead10, typename IHead11, typename IHead12>
-struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
-                            IHead9, IHead10, IHead11, IHead12> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
-    }
-
-    template <typename Ret, typename Visitor, typename T, typename U>
-#ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
-#else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
-#endif
-    {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
-        }
-    }
-};
-
-template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
-          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
-          typename IHead10, typename IHead11, typename IHead12, typename IHead13>
-struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
-                            IHead9, IHead10, IHead11, IHead12, IHead13> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
-    }
-
-    template <typename Ret, typename Visitor, typename T, typename U>
-#ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
-#else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
-#endif
-    {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
-        }
-    }
-};
-
-template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
-          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
-          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14>
-struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
-                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
-    }
-
-    template <typename Ret, typename Visitor, typename T, typename U>
-#ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
-#else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
-#endif
-    {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
-        }
-    }
-};
-
-template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
-          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
-          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
-          typename IHead15>
-struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
-                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        case IHead15::value:
-            return visitor(IHead15{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
-    }
-
-    template <typename Ret, typename Visitor, typename T, typename U>
-#ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
-#else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
-#endif
-    {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        case IHead15::value:
-            return visitor(IHead15{});
-        default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
-        }
-    }
-};
-
-template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
-          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
-          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
-          typename IHead15, typename IHead16>
-struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
-                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        case IHead15::value:
-            return visitor(IHead15{});
-        case IHead16::value:
-            return visitor(IHead16{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
-    }
-
-    template <typename Ret, typename Visitor, typename T, typename U>
-#ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
-#else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
-#endif
-    {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        case IHead15::value:
-            return visitor(IHead15{});
-        case IHead16::value:
-            return visitor(IHead16{});
-        default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
-        }
-    }
-};
-
-template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
-          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
-          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
-          typename IHead15, typename IHead16, typename IHead17>
-struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
-                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
-                            IHead17> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        case IHead15::value:
-            return visitor(IHead15{});
-        case IHead16::value:
-            return visitor(IHead16{});
-        case IHead17::value:
-            return visitor(IHead17{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
-    }
-
-    template <typename Ret, typename Visitor, typename T, typename U>
-#ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
-#else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
-#endif
-    {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        case IHead15::value:
-            return visitor(IHead15{});
-        case IHead16::value:
-            return visitor(IHead16{});
-        case IHead17::value:
-            return visitor(IHead17{});
-        default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
-        }
-    }
-};
-
-template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
-          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
-          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
-          typename IHead15, typename IHead16, typename IHead17, typename IHead18>
-struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
-                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
-                            IHead17, IHead18> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        case IHead15::value:
-            return visitor(IHead15{});
-        case IHead16::value:
-            return visitor(IHead16{});
-        case IHead17::value:
-            return visitor(IHead17{});
-        case IHead18::value:
-            return visitor(IHead18{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
-    }
-
-    template <typename Ret, typename Visitor, typename T, typename U>
-#ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
-#else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
-#endif
-    {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        case IHead15::value:
-            return visitor(IHead15{});
-        case IHead16::value:
-            return visitor(IHead16{});
-        case IHead17::value:
-            return visitor(IHead17{});
-        case IHead18::value:
-            return visitor(IHead18{});
-        default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
-        }
-    }
-};
-
-template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
-          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
-          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
-          typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19>
-struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
-                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
-                            IHead17, IHead18, IHead19> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        case IHead15::value:
-            return visitor(IHead15{});
-        case IHead16::value:
-            return visitor(IHead16{});
-        case IHead17::value:
-            return visitor(IHead17{});
-        case IHead18::value:
-            return visitor(IHead18{});
-        case IHead19::value:
-            return visitor(IHead19{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
-    }
-
-    template <typename Ret, typename Visitor, typename T, typename U>
-#ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
-#else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
-#endif
-    {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        case IHead15::value:
-            return visitor(IHead15{});
-        case IHead16::value:
-            return visitor(IHead16{});
-        case IHead17::value:
-            return visitor(IHead17{});
-        case IHead18::value:
-            return visitor(IHead18{});
-        case IHead19::value:
-            return visitor(IHead19{});
-        default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
-        }
-    }
-};
-
-template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
-          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
-          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
-          typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
-          typename IHead20>
-struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
-                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
-                            IHead17, IHead18, IHead19, IHead20> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        case IHead15::value:
-            return visitor(IHead15{});
-        case IHead16::value:
-            return visitor(IHead16{});
-        case IHead17::value:
-            return visitor(IHead17{});
-        case IHead18::value:
-            return visitor(IHead18{});
-        case IHead19::value:
-            return visitor(IHead19{});
-        case IHead20::value:
-            return visitor(IHead20{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
-    }
-
-    template <typename Ret, typename Visitor, typename T, typename U>
-#ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
-#else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
-#endif
-    {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        case IHead15::value:
-            return visitor(IHead15{});
-        case IHead16::value:
-            return visitor(IHead16{});
-        case IHead17::value:
-            return visitor(IHead17{});
-        case IHead18::value:
-            return visitor(IHead18{});
-        case IHead19::value:
-            return visitor(IHead19{});
-        case IHead20::value:
-            return visitor(IHead20{});
-        default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
-        }
-    }
-};
-
-template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
-          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
-          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
-          typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
-          typename IHead20, typename IHead21>
-struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
-                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
-                            IHead17, IHead18, IHead19, IHead20, IHead21> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        case IHead15::value:
-            return visitor(IHead15{});
-        case IHead16::value:
-            return visitor(IHead16{});
-        case IHead17::value:
-            return visitor(IHead17{});
-        case IHead18::value:
-            return visitor(IHead18{});
-        case IHead19::value:
-            return visitor(IHead19{});
-        case IHead20::value:
-            return visitor(IHead20{});
-        case IHead21::value:
-            return visitor(IHead21{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
-    }
-
-    template <typename Ret, typename Visitor, typename T, typename U>
-#ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
-#else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -1800,102 +814,23 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead11{});
         case IHead12::value:
             return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        case IHead15::value:
-            return visitor(IHead15{});
-        case IHead16::value:
-            return visitor(IHead16{});
-        case IHead17::value:
-            return visitor(IHead17{});
-        case IHead18::value:
-            return visitor(IHead18{});
-        case IHead19::value:
-            return visitor(IHead19{});
-        case IHead20::value:
-            return visitor(IHead20{});
-        case IHead21::value:
-            return visitor(IHead21{});
         default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return miss(std::forward<T>(value));
         }
     }
 };
 
 template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
           typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
-          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
-          typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
-          typename IHead20, typename IHead21, typename IHead22>
+          typename IHead10, typename IHead11, typename IHead12, typename IHead13>
 struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
-                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
-                            IHead17, IHead18, IHead19, IHead20, IHead21, IHead22> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        case IHead15::value:
-            return visitor(IHead15{});
-        case IHead16::value:
-            return visitor(IHead16{});
-        case IHead17::value:
-            return visitor(IHead17{});
-        case IHead18::value:
-            return visitor(IHead18{});
-        case IHead19::value:
-            return visitor(IHead19{});
-        case IHead20::value:
-            return visitor(IHead20{});
-        case IHead21::value:
-            return visitor(IHead21{});
-        case IHead22::value:
-            return visitor(IHead22{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
-    }
-
-    template <typename Ret, typename Visitor, typename T, typename U>
+                            IHead9, IHead10, IHead11, IHead12, IHead13> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -1927,104 +862,23 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead12{});
         case IHead13::value:
             return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        case IHead15::value:
-            return visitor(IHead15{});
-        case IHead16::value:
-            return visitor(IHead16{});
-        case IHead17::value:
-            return visitor(IHead17{});
-        case IHead18::value:
-            return visitor(IHead18{});
-        case IHead19::value:
-            return visitor(IHead19{});
-        case IHead20::value:
-            return visitor(IHead20{});
-        case IHead21::value:
-            return visitor(IHead21{});
-        case IHead22::value:
-            return visitor(IHead22{});
         default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return miss(std::forward<T>(value));
         }
     }
 };
 
 template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
           typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
-          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
-          typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
-          typename IHead20, typename IHead21, typename IHead22, typename IHead23>
+          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14>
 struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
-                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
-                            IHead17, IHead18, IHead19, IHead20, IHead21, IHead22, IHead23> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        case IHead15::value:
-            return visitor(IHead15{});
-        case IHead16::value:
-            return visitor(IHead16{});
-        case IHead17::value:
-            return visitor(IHead17{});
-        case IHead18::value:
-            return visitor(IHead18{});
-        case IHead19::value:
-            return visitor(IHead19{});
-        case IHead20::value:
-            return visitor(IHead20{});
-        case IHead21::value:
-            return visitor(IHead21{});
-        case IHead22::value:
-            return visitor(IHead22{});
-        case IHead23::value:
-            return visitor(IHead23{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
-    }
-
-    template <typename Ret, typename Visitor, typename T, typename U>
+                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -2058,107 +912,24 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead13{});
         case IHead14::value:
             return visitor(IHead14{});
-        case IHead15::value:
-            return visitor(IHead15{});
-        case IHead16::value:
-            return visitor(IHead16{});
-        case IHead17::value:
-            return visitor(IHead17{});
-        case IHead18::value:
-            return visitor(IHead18{});
-        case IHead19::value:
-            return visitor(IHead19{});
-        case IHead20::value:
-            return visitor(IHead20{});
-        case IHead21::value:
-            return visitor(IHead21{});
-        case IHead22::value:
-            return visitor(IHead22{});
-        case IHead23::value:
-            return visitor(IHead23{});
         default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return miss(std::forward<T>(value));
         }
     }
 };
 
 template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
           typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
-          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
-          typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
-          typename IHead20, typename IHead21, typename IHead22, typename IHead23, typename IHead24>
-struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
-                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
-                            IHead17, IHead18, IHead19, IHead20, IHead21, IHead22, IHead23,
-                            IHead24> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
-        switch (value) {
-        case IHead0::value:
-            return visitor(IHead0{});
-        case IHead1::value:
-            return visitor(IHead1{});
-        case IHead2::value:
-            return visitor(IHead2{});
-        case IHead3::value:
-            return visitor(IHead3{});
-        case IHead4::value:
-            return visitor(IHead4{});
-        case IHead5::value:
-            return visitor(IHead5{});
-        case IHead6::value:
-            return visitor(IHead6{});
-        case IHead7::value:
-            return visitor(IHead7{});
-        case IHead8::value:
-            return visitor(IHead8{});
-        case IHead9::value:
-            return visitor(IHead9{});
-        case IHead10::value:
-            return visitor(IHead10{});
-        case IHead11::value:
-            return visitor(IHead11{});
-        case IHead12::value:
-            return visitor(IHead12{});
-        case IHead13::value:
-            return visitor(IHead13{});
-        case IHead14::value:
-            return visitor(IHead14{});
-        case IHead15::value:
-            return visitor(IHead15{});
-        case IHead16::value:
-            return visitor(IHead16{});
-        case IHead17::value:
-            return visitor(IHead17{});
-        case IHead18::value:
-            return visitor(IHead18{});
-        case IHead19::value:
-            return visitor(IHead19{});
-        case IHead20::value:
-            return visitor(IHead20{});
-        case IHead21::value:
-            return visitor(IHead21{});
-        case IHead22::value:
-            return visitor(IHead22{});
-        case IHead23::value:
-            return visitor(IHead23{});
-        case IHead24::value:
-            return visitor(IHead24{});
-        default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
-        }
-    }
-
-    template <typename Ret, typename Visitor, typename T, typename U>
+          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
+          typename IHead15>
+struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
+                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -2194,28 +965,8 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead14{});
         case IHead15::value:
             return visitor(IHead15{});
-        case IHead16::value:
-            return visitor(IHead16{});
-        case IHead17::value:
-            return visitor(IHead17{});
-        case IHead18::value:
-            return visitor(IHead18{});
-        case IHead19::value:
-            return visitor(IHead19{});
-        case IHead20::value:
-            return visitor(IHead20{});
-        case IHead21::value:
-            return visitor(IHead21{});
-        case IHead22::value:
-            return visitor(IHead22{});
-        case IHead23::value:
-            return visitor(IHead23{});
-        case IHead24::value:
-            return visitor(IHead24{});
         default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return miss(std::forward<T>(value));
         }
     }
 };
@@ -2223,15 +974,17 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
 template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
           typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
           typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
-          typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
-          typename IHead20, typename IHead21, typename IHead22, typename IHead23, typename IHead24,
-          typename IHead25>
+          typename IHead15, typename IHead16>
 struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
-                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
-                            IHead17, IHead18, IHead19, IHead20, IHead21, IHead22, IHead23, IHead24,
-                            IHead25> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
+                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
+#ifdef USE_CPP_14_CONSTEXPR
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
+#else
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
+#endif
+    {
         switch (value) {
         case IHead0::value:
             return visitor(IHead0{});
@@ -2267,37 +1020,25 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead15{});
         case IHead16::value:
             return visitor(IHead16{});
-        case IHead17::value:
-            return visitor(IHead17{});
-        case IHead18::value:
-            return visitor(IHead18{});
-        case IHead19::value:
-            return visitor(IHead19{});
-        case IHead20::value:
-            return visitor(IHead20{});
-        case IHead21::value:
-            return visitor(IHead21{});
-        case IHead22::value:
-            return visitor(IHead22{});
-        case IHead23::value:
-            return visitor(IHead23{});
-        case IHead24::value:
-            return visitor(IHead24{});
-        case IHead25::value:
-            return visitor(IHead25{});
         default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
+            return miss(std::forward<T>(value));
         }
     }
+};
 
-    template <typename Ret, typename Visitor, typename T, typename U>
+template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
+          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
+          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
+          typename IHead15, typename IHead16, typename IHead17>
+struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
+                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
+                            IHead17> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -2337,26 +1078,8 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead16{});
         case IHead17::value:
             return visitor(IHead17{});
-        case IHead18::value:
-            return visitor(IHead18{});
-        case IHead19::value:
-            return visitor(IHead19{});
-        case IHead20::value:
-            return visitor(IHead20{});
-        case IHead21::value:
-            return visitor(IHead21{});
-        case IHead22::value:
-            return visitor(IHead22{});
-        case IHead23::value:
-            return visitor(IHead23{});
-        case IHead24::value:
-            return visitor(IHead24{});
-        case IHead25::value:
-            return visitor(IHead25{});
         default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return miss(std::forward<T>(value));
         }
     }
 };
@@ -2364,15 +1087,18 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
 template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
           typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
           typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
-          typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
-          typename IHead20, typename IHead21, typename IHead22, typename IHead23, typename IHead24,
-          typename IHead25, typename IHead26>
+          typename IHead15, typename IHead16, typename IHead17, typename IHead18>
 struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
                             IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
-                            IHead17, IHead18, IHead19, IHead20, IHead21, IHead22, IHead23, IHead24,
-                            IHead25, IHead26> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
+                            IHead17, IHead18> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
+#ifdef USE_CPP_14_CONSTEXPR
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
+#else
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
+#endif
+    {
         switch (value) {
         case IHead0::value:
             return visitor(IHead0{});
@@ -2412,35 +1138,25 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead17{});
         case IHead18::value:
             return visitor(IHead18{});
-        case IHead19::value:
-            return visitor(IHead19{});
-        case IHead20::value:
-            return visitor(IHead20{});
-        case IHead21::value:
-            return visitor(IHead21{});
-        case IHead22::value:
-            return visitor(IHead22{});
-        case IHead23::value:
-            return visitor(IHead23{});
-        case IHead24::value:
-            return visitor(IHead24{});
-        case IHead25::value:
-            return visitor(IHead25{});
-        case IHead26::value:
-            return visitor(IHead26{});
         default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
+            return miss(std::forward<T>(value));
         }
     }
+};
 
-    template <typename Ret, typename Visitor, typename T, typename U>
+template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
+          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
+          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
+          typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19>
+struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
+                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
+                            IHead17, IHead18, IHead19> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -2484,24 +1200,8 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead18{});
         case IHead19::value:
             return visitor(IHead19{});
-        case IHead20::value:
-            return visitor(IHead20{});
-        case IHead21::value:
-            return visitor(IHead21{});
-        case IHead22::value:
-            return visitor(IHead22{});
-        case IHead23::value:
-            return visitor(IHead23{});
-        case IHead24::value:
-            return visitor(IHead24{});
-        case IHead25::value:
-            return visitor(IHead25{});
-        case IHead26::value:
-            return visitor(IHead26{});
         default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return miss(std::forward<T>(value));
         }
     }
 };
@@ -2510,14 +1210,18 @@ template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, ty
           typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
           typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
           typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
-          typename IHead20, typename IHead21, typename IHead22, typename IHead23, typename IHead24,
-          typename IHead25, typename IHead26, typename IHead27>
+          typename IHead20>
 struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
                             IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
-                            IHead17, IHead18, IHead19, IHead20, IHead21, IHead22, IHead23, IHead24,
-                            IHead25, IHead26, IHead27> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
+                            IHead17, IHead18, IHead19, IHead20> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
+#ifdef USE_CPP_14_CONSTEXPR
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
+#else
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
+#endif
+    {
         switch (value) {
         case IHead0::value:
             return visitor(IHead0{});
@@ -2561,33 +1265,26 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead19{});
         case IHead20::value:
             return visitor(IHead20{});
-        case IHead21::value:
-            return visitor(IHead21{});
-        case IHead22::value:
-            return visitor(IHead22{});
-        case IHead23::value:
-            return visitor(IHead23{});
-        case IHead24::value:
-            return visitor(IHead24{});
-        case IHead25::value:
-            return visitor(IHead25{});
-        case IHead26::value:
-            return visitor(IHead26{});
-        case IHead27::value:
-            return visitor(IHead27{});
         default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
+            return miss(std::forward<T>(value));
         }
     }
+};
 
-    template <typename Ret, typename Visitor, typename T, typename U>
+template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
+          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
+          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
+          typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
+          typename IHead20, typename IHead21>
+struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
+                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
+                            IHead17, IHead18, IHead19, IHead20, IHead21> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -2635,22 +1332,8 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead20{});
         case IHead21::value:
             return visitor(IHead21{});
-        case IHead22::value:
-            return visitor(IHead22{});
-        case IHead23::value:
-            return visitor(IHead23{});
-        case IHead24::value:
-            return visitor(IHead24{});
-        case IHead25::value:
-            return visitor(IHead25{});
-        case IHead26::value:
-            return visitor(IHead26{});
-        case IHead27::value:
-            return visitor(IHead27{});
         default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return miss(std::forward<T>(value));
         }
     }
 };
@@ -2659,14 +1342,18 @@ template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, ty
           typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
           typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
           typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
-          typename IHead20, typename IHead21, typename IHead22, typename IHead23, typename IHead24,
-          typename IHead25, typename IHead26, typename IHead27, typename IHead28>
+          typename IHead20, typename IHead21, typename IHead22>
 struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
                             IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
-                            IHead17, IHead18, IHead19, IHead20, IHead21, IHead22, IHead23, IHead24,
-                            IHead25, IHead26, IHead27, IHead28> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
+                            IHead17, IHead18, IHead19, IHead20, IHead21, IHead22> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
+#ifdef USE_CPP_14_CONSTEXPR
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
+#else
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
+#endif
+    {
         switch (value) {
         case IHead0::value:
             return visitor(IHead0{});
@@ -2714,31 +1401,26 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead21{});
         case IHead22::value:
             return visitor(IHead22{});
-        case IHead23::value:
-            return visitor(IHead23{});
-        case IHead24::value:
-            return visitor(IHead24{});
-        case IHead25::value:
-            return visitor(IHead25{});
-        case IHead26::value:
-            return visitor(IHead26{});
-        case IHead27::value:
-            return visitor(IHead27{});
-        case IHead28::value:
-            return visitor(IHead28{});
         default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
+            return miss(std::forward<T>(value));
         }
     }
+};
 
-    template <typename Ret, typename Visitor, typename T, typename U>
+template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
+          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
+          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
+          typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
+          typename IHead20, typename IHead21, typename IHead22, typename IHead23>
+struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
+                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
+                            IHead17, IHead18, IHead19, IHead20, IHead21, IHead22, IHead23> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -2790,20 +1472,8 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead22{});
         case IHead23::value:
             return visitor(IHead23{});
-        case IHead24::value:
-            return visitor(IHead24{});
-        case IHead25::value:
-            return visitor(IHead25{});
-        case IHead26::value:
-            return visitor(IHead26{});
-        case IHead27::value:
-            return visitor(IHead27{});
-        case IHead28::value:
-            return visitor(IHead28{});
         default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return miss(std::forward<T>(value));
         }
     }
 };
@@ -2812,14 +1482,19 @@ template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, ty
           typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
           typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
           typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
-          typename IHead20, typename IHead21, typename IHead22, typename IHead23, typename IHead24,
-          typename IHead25, typename IHead26, typename IHead27, typename IHead28, typename IHead29>
+          typename IHead20, typename IHead21, typename IHead22, typename IHead23, typename IHead24>
 struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
                             IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
-                            IHead17, IHead18, IHead19, IHead20, IHead21, IHead22, IHead23, IHead24,
-                            IHead25, IHead26, IHead27, IHead28, IHead29> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
+                            IHead17, IHead18, IHead19, IHead20, IHead21, IHead22, IHead23,
+                            IHead24> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
+#ifdef USE_CPP_14_CONSTEXPR
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
+#else
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
+#endif
+    {
         switch (value) {
         case IHead0::value:
             return visitor(IHead0{});
@@ -2871,29 +1546,28 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead23{});
         case IHead24::value:
             return visitor(IHead24{});
-        case IHead25::value:
-            return visitor(IHead25{});
-        case IHead26::value:
-            return visitor(IHead26{});
-        case IHead27::value:
-            return visitor(IHead27{});
-        case IHead28::value:
-            return visitor(IHead28{});
-        case IHead29::value:
-            return visitor(IHead29{});
         default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
+            return miss(std::forward<T>(value));
         }
     }
+};
 
-    template <typename Ret, typename Visitor, typename T, typename U>
+template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
+          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
+          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
+          typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
+          typename IHead20, typename IHead21, typename IHead22, typename IHead23, typename IHead24,
+          typename IHead25>
+struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
+                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
+                            IHead17, IHead18, IHead19, IHead20, IHead21, IHead22, IHead23, IHead24,
+                            IHead25> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -2949,18 +1623,8 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead24{});
         case IHead25::value:
             return visitor(IHead25{});
-        case IHead26::value:
-            return visitor(IHead26{});
-        case IHead27::value:
-            return visitor(IHead27{});
-        case IHead28::value:
-            return visitor(IHead28{});
-        case IHead29::value:
-            return visitor(IHead29{});
         default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return miss(std::forward<T>(value));
         }
     }
 };
@@ -2970,14 +1634,19 @@ template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, ty
           typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
           typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
           typename IHead20, typename IHead21, typename IHead22, typename IHead23, typename IHead24,
-          typename IHead25, typename IHead26, typename IHead27, typename IHead28, typename IHead29,
-          typename IHead30>
+          typename IHead25, typename IHead26>
 struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
                             IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
                             IHead17, IHead18, IHead19, IHead20, IHead21, IHead22, IHead23, IHead24,
-                            IHead25, IHead26, IHead27, IHead28, IHead29, IHead30> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
+                            IHead25, IHead26> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
+#ifdef USE_CPP_14_CONSTEXPR
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
+#else
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
+#endif
+    {
         switch (value) {
         case IHead0::value:
             return visitor(IHead0{});
@@ -3033,27 +1702,28 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead25{});
         case IHead26::value:
             return visitor(IHead26{});
-        case IHead27::value:
-            return visitor(IHead27{});
-        case IHead28::value:
-            return visitor(IHead28{});
-        case IHead29::value:
-            return visitor(IHead29{});
-        case IHead30::value:
-            return visitor(IHead30{});
         default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
+            return miss(std::forward<T>(value));
         }
     }
+};
 
-    template <typename Ret, typename Visitor, typename T, typename U>
+template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
+          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
+          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
+          typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
+          typename IHead20, typename IHead21, typename IHead22, typename IHead23, typename IHead24,
+          typename IHead25, typename IHead26, typename IHead27>
+struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
+                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
+                            IHead17, IHead18, IHead19, IHead20, IHead21, IHead22, IHead23, IHead24,
+                            IHead25, IHead26, IHead27> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -3113,16 +1783,8 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead26{});
         case IHead27::value:
             return visitor(IHead27{});
-        case IHead28::value:
-            return visitor(IHead28{});
-        case IHead29::value:
-            return visitor(IHead29{});
-        case IHead30::value:
-            return visitor(IHead30{});
         default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return miss(std::forward<T>(value));
         }
     }
 };
@@ -3132,14 +1794,19 @@ template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, ty
           typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
           typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
           typename IHead20, typename IHead21, typename IHead22, typename IHead23, typename IHead24,
-          typename IHead25, typename IHead26, typename IHead27, typename IHead28, typename IHead29,
-          typename IHead30, typename IHead31>
+          typename IHead25, typename IHead26, typename IHead27, typename IHead28>
 struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
                             IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
                             IHead17, IHead18, IHead19, IHead20, IHead21, IHead22, IHead23, IHead24,
-                            IHead25, IHead26, IHead27, IHead28, IHead29, IHead30, IHead31> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
+                            IHead25, IHead26, IHead27, IHead28> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
+#ifdef USE_CPP_14_CONSTEXPR
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
+#else
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
+#endif
+    {
         switch (value) {
         case IHead0::value:
             return visitor(IHead0{});
@@ -3199,25 +1866,28 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead27{});
         case IHead28::value:
             return visitor(IHead28{});
-        case IHead29::value:
-            return visitor(IHead29{});
-        case IHead30::value:
-            return visitor(IHead30{});
-        case IHead31::value:
-            return visitor(IHead31{});
         default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
+            return miss(std::forward<T>(value));
         }
     }
+};
 
-    template <typename Ret, typename Visitor, typename T, typename U>
+template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
+          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
+          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
+          typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
+          typename IHead20, typename IHead21, typename IHead22, typename IHead23, typename IHead24,
+          typename IHead25, typename IHead26, typename IHead27, typename IHead28, typename IHead29>
+struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
+                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
+                            IHead17, IHead18, IHead19, IHead20, IHead21, IHead22, IHead23, IHead24,
+                            IHead25, IHead26, IHead27, IHead28, IHead29> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -3281,14 +1951,8 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead28{});
         case IHead29::value:
             return visitor(IHead29{});
-        case IHead30::value:
-            return visitor(IHead30{});
-        case IHead31::value:
-            return visitor(IHead31{});
         default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return miss(std::forward<T>(value));
         }
     }
 };
@@ -3299,14 +1963,19 @@ template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, ty
           typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
           typename IHead20, typename IHead21, typename IHead22, typename IHead23, typename IHead24,
           typename IHead25, typename IHead26, typename IHead27, typename IHead28, typename IHead29,
-          typename IHead30, typename IHead31, typename IHead32>
+          typename IHead30>
 struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
                             IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
                             IHead17, IHead18, IHead19, IHead20, IHead21, IHead22, IHead23, IHead24,
-                            IHead25, IHead26, IHead27, IHead28, IHead29, IHead30, IHead31,
-                            IHead32> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
+                            IHead25, IHead26, IHead27, IHead28, IHead29, IHead30> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
+#ifdef USE_CPP_14_CONSTEXPR
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
+#else
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
+#endif
+    {
         switch (value) {
         case IHead0::value:
             return visitor(IHead0{});
@@ -3370,23 +2039,29 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead29{});
         case IHead30::value:
             return visitor(IHead30{});
-        case IHead31::value:
-            return visitor(IHead31{});
-        case IHead32::value:
-            return visitor(IHead32{});
         default:
-            return integral_switch_impl<>::template dispatch<Ret>(std::forward<Visitor>(visitor),
-                                                                  std::forward<T>(value));
+            return miss(std::forward<T>(value));
         }
     }
+};
 
-    template <typename Ret, typename Visitor, typename T, typename U>
+template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
+          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
+          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
+          typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
+          typename IHead20, typename IHead21, typename IHead22, typename IHead23, typename IHead24,
+          typename IHead25, typename IHead26, typename IHead27, typename IHead28, typename IHead29,
+          typename IHead30, typename IHead31>
+struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
+                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
+                            IHead17, IHead18, IHead19, IHead20, IHead21, IHead22, IHead23, IHead24,
+                            IHead25, IHead26, IHead27, IHead28, IHead29, IHead30, IHead31> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -3454,12 +2129,8 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead30{});
         case IHead31::value:
             return visitor(IHead31{});
-        case IHead32::value:
-            return visitor(IHead32{});
         default:
-            return integral_switch_impl<>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return miss(std::forward<T>(value));
         }
     }
 };
@@ -3470,14 +2141,20 @@ template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, ty
           typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
           typename IHead20, typename IHead21, typename IHead22, typename IHead23, typename IHead24,
           typename IHead25, typename IHead26, typename IHead27, typename IHead28, typename IHead29,
-          typename IHead30, typename IHead31, typename... ITail>
+          typename IHead30, typename IHead31, typename IHead32>
 struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
                             IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
                             IHead17, IHead18, IHead19, IHead20, IHead21, IHead22, IHead23, IHead24,
                             IHead25, IHead26, IHead27, IHead28, IHead29, IHead30, IHead31,
-                            ITail...> {
-    template <typename Ret, typename Visitor, typename T>
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value) {
+                            IHead32> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
+#ifdef USE_CPP_14_CONSTEXPR
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
+#else
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
+#endif
+    {
         switch (value) {
         case IHead0::value:
             return visitor(IHead0{});
@@ -3543,19 +2220,32 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
             return visitor(IHead30{});
         case IHead31::value:
             return visitor(IHead31{});
+        case IHead32::value:
+            return visitor(IHead32{});
         default:
-            return integral_switch_impl<ITail...>::template dispatch<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value));
+            return miss(std::forward<T>(value));
         }
     }
+};
 
-    template <typename Ret, typename Visitor, typename T, typename U>
+template <typename IHead0, typename IHead1, typename IHead2, typename IHead3, typename IHead4,
+          typename IHead5, typename IHead6, typename IHead7, typename IHead8, typename IHead9,
+          typename IHead10, typename IHead11, typename IHead12, typename IHead13, typename IHead14,
+          typename IHead15, typename IHead16, typename IHead17, typename IHead18, typename IHead19,
+          typename IHead20, typename IHead21, typename IHead22, typename IHead23, typename IHead24,
+          typename IHead25, typename IHead26, typename IHead27, typename IHead28, typename IHead29,
+          typename IHead30, typename IHead31, typename... ITail>
+struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHead6, IHead7, IHead8,
+                            IHead9, IHead10, IHead11, IHead12, IHead13, IHead14, IHead15, IHead16,
+                            IHead17, IHead18, IHead19, IHead20, IHead21, IHead22, IHead23, IHead24,
+                            IHead25, IHead26, IHead27, IHead28, IHead29, IHead30, IHead31,
+                            ITail...> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
 #ifdef USE_CPP_14_CONSTEXPR
-    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch_nothrow(Visitor &&visitor,
-                                                                        T &&value, U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, T &&value,
+                                                                Miss &&miss)
 #else
-    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_nothrow(Visitor &&visitor, T &&value,
-                                                              U &&default_ret)
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T &&value, Miss &&miss)
 #endif
     {
         switch (value) {
@@ -3624,42 +2314,260 @@ struct integral_switch_impl<IHead0, IHead1, IHead2, IHead3, IHead4, IHead5, IHea
         case IHead31::value:
             return visitor(IHead31{});
         default:
-            return integral_switch_impl<ITail...>::template dispatch_nothrow<Ret>(
-                std::forward<Visitor>(visitor), std::forward<T>(value),
-                std::forward<U>(default_ret));
+            return integral_switch_impl<ITail...>::template dispatch<Ret>(
+                std::forward<Visitor>(visitor), std::forward<T>(value), std::forward<Miss>(miss));
+        }
+    }
+};
+
+#endif
+
+template <typename T, bool = std::is_enum<T>::value> struct underlying {
+    using type = T;
+};
+
+template <typename T> struct underlying<T, true> {
+    using type = typename std::underlying_type<T>::type;
+};
+
+template <typename T> constexpr typename underlying<T>::type to_underlying(T key) {
+    return static_cast<typename underlying<T>::type>(key);
+}
+
+// Distance from first to key, wrapping around for keys smaller than first.
+template <typename K>
+constexpr typename std::make_unsigned<K>::type key_offset(K key, K first) {
+    using offset_type = typename std::make_unsigned<K>::type;
+    return static_cast<offset_type>(static_cast<offset_type>(key) -
+                                    static_cast<offset_type>(first));
+}
+
+// Compares integers of any signedness by their values, like std::cmp_less.
+template <bool SignedA, bool SignedB> struct integral_compare {
+    template <typename A, typename B> static constexpr bool less(A a, B b) { return a < b; }
+};
+
+template <> struct integral_compare<true, false> {
+    template <typename A, typename B> static constexpr bool less(A a, B b) {
+        return a < 0 || static_cast<typename std::make_unsigned<A>::type>(a) < b;
+    }
+};
+
+template <> struct integral_compare<false, true> {
+    template <typename A, typename B> static constexpr bool less(A a, B b) {
+        return b > 0 && a < static_cast<typename std::make_unsigned<B>::type>(b);
+    }
+};
+
+template <typename A, typename B> constexpr bool integral_less(A a, B b) {
+    return integral_compare<std::is_signed<A>::value, std::is_signed<B>::value>::less(a, b);
+}
+
+// Whether the value lies within the range of the key type T. The check is done in the type of the
+// value, so that a value which does not fit is never converted to T, where it may wrap onto a key.
+template <typename T, typename U> constexpr bool in_key_range(U value) {
+    using key_type = typename underlying<T>::type;
+
+    return !integral_less(to_underlying(value), std::numeric_limits<key_type>::min()) &&
+           !integral_less(std::numeric_limits<key_type>::max(), to_underlying(value));
+}
+
+// Halves the range on every call so the recursion depth stays logarithmic in the number of keys.
+template <typename T>
+constexpr bool is_ascending(const T *keys, std::size_t first, std::size_t count) {
+    return count < 2    ? true
+           : count == 2 ? keys[first] < keys[first + 1]
+                        : is_ascending(keys, first, count / 2 + 1) &&
+                              is_ascending(keys, first + count / 2, count - count / 2);
+}
+
+template <typename T, T... v> struct ascending_keys {
+    static constexpr bool value = is_ascending(key_array<T, v...>::values, 0, sizeof...(v));
+};
+
+// Neither call_case nor its instantiations depend on the whole key set, which keeps building a
+// thunk_table linear in the number of keys.
+template <typename Ret, typename Visitor, typename K> constexpr Ret call_case(Visitor &visitor) {
+    return visitor(K{});
+}
+
+template <typename Ret, typename Visitor, typename T, T... v> struct thunk_table {
+    using thunk_type = Ret (*)(Visitor &);
+
+    static constexpr thunk_type values[sizeof...(v)] = {
+        &call_case<Ret, Visitor, std::integral_constant<T, v>>...};
+};
+
+template <typename Ret, typename Visitor, typename T, T... v>
+constexpr typename thunk_table<Ret, Visitor, T, v...>::thunk_type
+    thunk_table<Ret, Visitor, T, v...>::values[sizeof...(v)];
+
+#ifdef USE_CPP_17_FOLD_BACKEND
+// Compares the value against every key in a single fold expression that stops at the first match,
+// so that no generated switch statement or recursive instantiation is needed. Only trivial results
+// are assigned to a local in the fold; constructing and assigning others, e.g. std::string, in
+// every case bloats the code, so they are returned through a thunk_table instead.
+template <typename T, T... v> struct fold_switch_impl {
+    template <typename Ret, typename Visitor, typename U, typename Miss>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, U &&value,
+                                                                Miss &&miss) {
+        if (!in_key_range<T>(value)) {
+            return miss(std::forward<U>(value));
         }
+
+        const T key = static_cast<T>(value);
+
+        if constexpr (std::is_void<Ret>::value) {
+            if (!((key == v && (visitor(std::integral_constant<T, v>{}), true)) || ...)) {
+                miss(std::forward<U>(value));
+            }
+        } else if constexpr (std::is_trivially_default_constructible<Ret>::value &&
+                             std::is_trivially_move_assignable<Ret>::value) {
+            Ret ret{};
+
+            if (((key == v &&
+                  (static_cast<void>(ret = visitor(std::integral_constant<T, v>{})), true)) ||
+                 ...)) {
+                return ret;
+            }
+
+            return miss(std::forward<U>(value));
+        } else {
+            using table = thunk_table<Ret, typename std::remove_reference<Visitor>::type, T, v...>;
+
+            std::size_t i = 0;
+
+            return ((key == v || (++i, false)) || ...) ? table::values[i](visitor)
+                                                        : miss(std::forward<U>(value));
+        }
+    }
+};
+
+template <typename T, T... v> using basic_switch_impl = fold_switch_impl<T, v...>;
+#else
+template <typename T, T... v>
+using basic_switch_impl = integral_switch_impl<std::integral_constant<T, v>...>;
+#endif
+
+// Large switches keep their keys in a flat array and call the visitor through a table of thunks,
+// so neither the instantiation depth nor the size of a single function grows with the number of
+// keys. Keys must be in ascending order; dense keys are found by indexing, others by binary search.
+template <typename T, T... v> struct table_switch_impl {
+    using keys = key_array<T, v...>;
+    using key_type = typename underlying<T>::type;
+
+    static constexpr std::size_t size = sizeof...(v);
+
+    static constexpr bool dense =
+        key_offset(to_underlying(keys::values[size - 1]), to_underlying(keys::values[0])) ==
+        size - 1;
+
+    static constexpr std::size_t lower_bound(key_type key, std::size_t first, std::size_t count) {
+        return count == 0 ? first
+                          : to_underlying(keys::values[first + count / 2]) < key
+                                ? lower_bound(key, first + count / 2 + 1, count - count / 2 - 1)
+                                : lower_bound(key, first, count / 2);
+    }
+
+    static constexpr std::size_t found(key_type key, std::size_t i) {
+        return i < size && to_underlying(keys::values[i]) == key ? i : size;
+    }
+
+    // Position of key in keys, or size if it is not one of the keys.
+    static constexpr std::size_t index_of(key_type key) {
+        return dense ? found(key, key_offset(key, to_underlying(keys::values[0])))
+                     : found(key, lower_bound(key, 0, size));
+    }
+
+    template <typename Ret, typename Visitor, typename U, typename Miss>
+#ifdef USE_CPP_14_CONSTEXPR
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr Ret dispatch(Visitor &&visitor, U &&value,
+                                                                Miss &&miss)
+#else
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, U &&value, Miss &&miss)
+#endif
+    {
+        using table = thunk_table<Ret, typename std::remove_reference<Visitor>::type, T, v...>;
+
+        const std::size_t i =
+            in_key_range<T>(value) ? index_of(to_underlying(static_cast<T>(value))) : size;
+
+        return i < size ? table::values[i](visitor) : miss(std::forward<U>(value));
     }
 };
 
+// Large key sets in ascending order use table_switch_impl, everything else basic_switch_impl.
+template <bool Large, typename T, T... v> struct select_switch_impl {
+    using type = basic_switch_impl<T, v...>;
+};
+
+template <typename T, T... v> struct select_switch_impl<true, T, v...> {
+    using type = typename std::conditional<ascending_keys<T, v...>::value,
+                                           table_switch_impl<T, v...>,
+                                           basic_switch_impl<T, v...>>::type;
+};
+
+template <typename T, T... v>
+using switch_impl_t =
+    typename select_switch_impl<(sizeof...(v) > INTEGRAL_SWITCH_TABLE_THRESHOLD), T, v...>::type;
+
+// Expands the key pack directly rather than through a member alias template, which GCC
+// instantiates in quadratic time for large key sets.
+template <typename Ret, typename Visitor, typename T, T... v>
+using same_return_types = all<
+    std::is_same<Ret, decltype(std::declval<Visitor>()(std::integral_constant<T, v>{}))>::value...>;
+
 } // namespace detail
 
 template <typename T, T... v> class integral_switch {
     template <typename Visitor, typename U>
     using return_type_of = decltype(std::declval<Visitor>()(std::declval<U>()));
 
+    using impl = detail::switch_impl_t<T, v...>;
+
   public:
     template <typename Visitor>
     using return_type = return_type_of<Visitor, detail::first_t<std::integral_constant<T, v>...>>;
 
-  private:
-    template <typename Visitor> struct check_return_type {
-        using expected_type = return_type<Visitor>;
+    template <typename Visitor>
+    using common_return_type =
+        typename std::common_type<return_type_of<Visitor, std::integral_constant<T, v>>...>::type;
 
-        template <T u> using actual_type = return_type_of<Visitor, std::integral_constant<T, u>>;
+#ifdef USE_CPP_17_VARIANT
+    template <typename Visitor>
+    using variant_return_type = typename detail::variant_of<typename detail::unique_types<
+        detail::type_list<>, return_type_of<Visitor, std::integral_constant<T, v>>...>::type>::type;
+#endif
 
+  private:
+    template <typename Visitor> struct check_return_type {
         static constexpr bool check() {
-            static_assert(detail::all<std::is_same<expected_type, actual_type<v>>::value...>::value,
+            static_assert(detail::same_return_types<return_type<Visitor>, Visitor, T, v...>::value,
                           "All return types must be equal");
             return true;
         }
     };
 
   public:
-    template <typename Visitor, typename U>
+    template <typename Policy = typename miss_policy<integral_switch>::type, typename Visitor,
+              typename U>
     static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor> visit(Visitor &&visitor, U &&value) {
         check_return_type<Visitor>::check();
-        return detail::integral_switch_impl<std::integral_constant<T, v>...>::template dispatch<
-            return_type<Visitor>>(std::forward<Visitor>(visitor), std::forward<U>(value));
+        return impl::template dispatch<return_type<Visitor>>(
+            std::forward<Visitor>(visitor), std::forward<U>(value),
+            detail::policy_on_miss<return_type<Visitor>, Policy>{});
+    }
+
+    // Sets ec instead of applying the miss policy when the value is not a key, and then returns
+    // a value initialised result.
+    template <typename Visitor, typename U>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor> visit(Visitor &&visitor, U &&value,
+                                                                    std::error_code &ec) {
+        check_return_type<Visitor>::check();
+        ec.clear();
+        return impl::template dispatch<return_type<Visitor>>(
+            std::forward<Visitor>(visitor), std::forward<U>(value),
+            detail::error_on_miss<return_type<Visitor>>{ec});
     }
 
     template <typename Visitor, typename U, typename R>
@@ -3672,10 +2580,78 @@ template <typename T, T... v> class integral_switch {
 #endif
     {
         check_return_type<Visitor>::check();
-        return detail::integral_switch_impl<std::integral_constant<T, v>...>::
-            template dispatch_nothrow<return_type<Visitor>>(std::forward<Visitor>(visitor),
-                                                            std::forward<U>(value),
-                                                            std::forward<R>(default_ret));
+        return impl::template dispatch<return_type<Visitor>>(
+            std::forward<Visitor>(visitor), std::forward<U>(value),
+            detail::return_on_miss<return_type<Visitor>, R>{std::forward<R>(default_ret)});
+    }
+
+    // Returns fallback(value) when the value is not a key.
+    template <typename Visitor, typename U, typename F>
+#ifdef USE_CPP_14_CONSTEXPR
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr return_type<Visitor>
+    visit_or(Visitor &&visitor, U &&value, F &&fallback)
+#else
+    static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor> visit_or(Visitor &&visitor, U &&value,
+                                                                       F &&fallback)
+#endif
+    {
+        check_return_type<Visitor>::check();
+        return impl::template dispatch<return_type<Visitor>>(
+            std::forward<Visitor>(visitor), std::forward<U>(value),
+            detail::call_on_miss<return_type<Visitor>, F>{std::forward<F>(fallback)});
+    }
+
+    // The value must be one of the keys. This is checked with assert() only.
+    template <typename Visitor, typename U>
+#ifdef USE_CPP_14_CONSTEXPR
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr return_type<Visitor>
+    visit_unchecked(Visitor &&visitor, U &&value)
+#else
+    static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor> visit_unchecked(Visitor &&visitor,
+                                                                              U &&value)
+#endif
+    {
+        check_return_type<Visitor>::check();
+        return impl::template dispatch<return_type<Visitor>>(
+            std::forward<Visitor>(visitor), std::forward<U>(value),
+            detail::policy_on_miss<return_type<Visitor>, unreachable_on_miss>{});
+    }
+
+    // Like visit(), but the cases may return different types. Their results are converted to
+    // common_return_type<Visitor>.
+    template <typename Policy = typename miss_policy<integral_switch>::type, typename Visitor,
+              typename U>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE common_return_type<Visitor> visit_common(Visitor &&visitor,
+                                                                                  U &&value) {
+        using converting = detail::converting_visitor<common_return_type<Visitor>, Visitor>;
+
+        return visit<Policy>(converting{std::forward<Visitor>(visitor)}, std::forward<U>(value));
+    }
+
+#ifdef USE_CPP_17_VARIANT
+    // Like visit(), but the cases may return different types. Their results are returned as a
+    // std::variant of the distinct result types, in the order of the keys.
+    template <typename Policy = typename miss_policy<integral_switch>::type, typename Visitor,
+              typename U>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE variant_return_type<Visitor>
+    visit_variant(Visitor &&visitor, U &&value) {
+        using constructing = detail::variant_visitor<variant_return_type<Visitor>, Visitor>;
+
+        return visit<Policy>(constructing{std::forward<Visitor>(visitor)}, std::forward<U>(value));
+    }
+#endif
+
+    // Returns a pointer to a function of the type Signature, e.g. void(const int *, std::size_t),
+    // that calls Visitor{}(std::integral_constant<T, v>{}, args...) for the key v that equals the
+    // value. Resolving a key that stays the same over a loop once, and calling the function in the
+    // loop, runs a body that is compiled for that key. The function has no state to call the
+    // visitor with, so the Visitor is given as a type and must be an empty class.
+    template <typename Signature, typename Visitor,
+              typename Policy = typename miss_policy<integral_switch>::type, typename U>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Signature *resolve(U &&value) {
+        static_assert(std::is_empty<Visitor>::value, "the visitor of resolve() must be stateless");
+
+        return visit<Policy>(detail::resolve_visitor<Visitor, Signature>{}, std::forward<U>(value));
     }
 };
 
@@ -3703,11 +2679,35 @@ template <typename... Ts> class variadic_switch {
     using return_type = typename SwitchImpl::template return_type<Wrapper<Visitor>>;
 
     template <typename Visitor>
+    using common_return_type = typename SwitchImpl::template common_return_type<Wrapper<Visitor>>;
+
+#ifdef USE_CPP_17_VARIANT
+    template <typename Visitor>
+    using variant_return_type = typename SwitchImpl::template variant_return_type<Wrapper<Visitor>>;
+#endif
+
+    // The I-th type and the position of the type U, which must occur once, e.g. to write the tag
+    // of a message that is later visited by its position.
+    template <std::size_t I> using type_at = detail::type_at<I, Ts...>;
+
+    template <typename U> static constexpr std::size_t index_of() {
+        return detail::type_index<U, Ts...>::value;
+    }
+
+    template <typename Policy = typename miss_policy<variadic_switch>::type, typename Visitor>
     static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor> visit(Visitor &&visitor,
                                                                     std::size_t i) {
         Wrapper<Visitor> wrapper{std::forward<Visitor>(visitor)};
 
-        return SwitchImpl::visit(std::forward<Wrapper<Visitor>>(wrapper), i);
+        return SwitchImpl::template visit<Policy>(std::forward<Wrapper<Visitor>>(wrapper), i);
+    }
+
+    template <typename Visitor>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor>
+    visit(Visitor &&visitor, std::size_t i, std::error_code &ec) {
+        Wrapper<Visitor> wrapper{std::forward<Visitor>(visitor)};
+
+        return SwitchImpl::visit(std::forward<Wrapper<Visitor>>(wrapper), i, ec);
     }
 
     template <typename Visitor, typename R>
@@ -3724,8 +2724,84 @@ template <typename... Ts> class variadic_switch {
         return SwitchImpl::visit_nothrow(std::forward<Wrapper<Visitor>>(wrapper), i,
                                          std::forward<R>(default_ret));
     }
+
+    template <typename Visitor, typename F>
+#ifdef USE_CPP_14_CONSTEXPR
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr return_type<Visitor>
+    visit_or(Visitor &&visitor, std::size_t i, F &&fallback)
+#else
+    static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor> visit_or(Visitor &&visitor,
+                                                                       std::size_t i, F &&fallback)
+#endif
+    {
+        Wrapper<Visitor> wrapper{std::forward<Visitor>(visitor)};
+
+        return SwitchImpl::visit_or(std::forward<Wrapper<Visitor>>(wrapper), i,
+                                    std::forward<F>(fallback));
+    }
+
+    template <typename Visitor>
+#ifdef USE_CPP_14_CONSTEXPR
+    static INTEGRAL_SWITCH_ALWAYS_INLINE constexpr return_type<Visitor>
+    visit_unchecked(Visitor &&visitor, std::size_t i)
+#else
+    static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor> visit_unchecked(Visitor &&visitor,
+                                                                              std::size_t i)
+#endif
+    {
+        Wrapper<Visitor> wrapper{std::forward<Visitor>(visitor)};
+
+        return SwitchImpl::visit_unchecked(std::forward<Wrapper<Visitor>>(wrapper), i);
+    }
+
+    template <typename Policy = typename miss_policy<variadic_switch>::type, typename Visitor>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE common_return_type<Visitor> visit_common(Visitor &&visitor,
+                                                                                  std::size_t i) {
+        Wrapper<Visitor> wrapper{std::forward<Visitor>(visitor)};
+
+        return SwitchImpl::template visit_common<Policy>(std::forward<Wrapper<Visitor>>(wrapper),
+                                                         i);
+    }
+
+#ifdef USE_CPP_17_VARIANT
+    template <typename Policy = typename miss_policy<variadic_switch>::type, typename Visitor>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE variant_return_type<Visitor>
+    visit_variant(Visitor &&visitor, std::size_t i) {
+        Wrapper<Visitor> wrapper{std::forward<Visitor>(visitor)};
+
+        return SwitchImpl::template visit_variant<Policy>(std::forward<Wrapper<Visitor>>(wrapper),
+                                                          i);
+    }
+#endif
+
+    // Like integral_switch::resolve(), but the function calls Visitor{}(type<T>{}, args...) for
+    // the i-th type T.
+    template <typename Signature, typename Visitor,
+              typename Policy = typename miss_policy<variadic_switch>::type>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Signature *resolve(std::size_t i) {
+        static_assert(std::is_empty<Visitor>::value, "the visitor of resolve() must be stateless");
+
+        using resolving = detail::resolve_type_visitor<Visitor, Signature, Ts...>;
+
+        return SwitchImpl::template visit<Policy>(resolving{}, i);
+    }
 };
 
+// Wraps a visitor so that each of its cases is compiled into a separate non-inlined function,
+// which keeps heavyweight visitors from bloating the function that calls visit(). The argument
+// types listed in Cold, e.g. std::integral_constant<T, v> or type<T>, are marked as cold cases.
+template <typename... Cold, typename Visitor>
+constexpr detail::outlined_visitor<Visitor, Cold...> outline(Visitor &&visitor) {
+    return {std::forward<Visitor>(visitor)};
+}
+
+// Converts the result of every case of the visitor to R, for example to a base class, and can be
+// passed to any of the visit functions.
+template <typename R, typename Visitor>
+constexpr detail::converting_visitor<R, Visitor> convert_result(Visitor &&visitor) {
+    return {std::forward<Visitor>(visitor)};
+}
+
 } // namespace integral_switch
 
 #endif
@@ -0,0 +1,420 @@
+/*
+ * kernel_switch.h
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef KERNEL_SWITCH_H_
+#define KERNEL_SWITCH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "integral_switch.h"
+
+// Number of elements that the generic path of a kernel_switch converts at a time.
+#ifndef INTEGRAL_SWITCH_KERNEL_CHUNK
+#define INTEGRAL_SWITCH_KERNEL_CHUNK 256
+#endif
+
+namespace integral_switch {
+
+// The element types of arrays.
+enum class dtype : std::uint8_t {
+    int8,
+    int16,
+    int32,
+    int64,
+    uint8,
+    uint16,
+    uint32,
+    uint64,
+    float32,
+    float64
+};
+
+template <dtype D> struct dtype_type; // undefined
+
+template <> struct dtype_type<dtype::int8> { using type = std::int8_t; };
+template <> struct dtype_type<dtype::int16> { using type = std::int16_t; };
+template <> struct dtype_type<dtype::int32> { using type = std::int32_t; };
+template <> struct dtype_type<dtype::int64> { using type = std::int64_t; };
+template <> struct dtype_type<dtype::uint8> { using type = std::uint8_t; };
+template <> struct dtype_type<dtype::uint16> { using type = std::uint16_t; };
+template <> struct dtype_type<dtype::uint32> { using type = std::uint32_t; };
+template <> struct dtype_type<dtype::uint64> { using type = std::uint64_t; };
+template <> struct dtype_type<dtype::float32> { using type = float; };
+template <> struct dtype_type<dtype::float64> { using type = double; };
+
+template <typename T> struct dtype_of; // undefined
+
+template <> struct dtype_of<std::int8_t> : std::integral_constant<dtype, dtype::int8> {};
+template <> struct dtype_of<std::int16_t> : std::integral_constant<dtype, dtype::int16> {};
+template <> struct dtype_of<std::int32_t> : std::integral_constant<dtype, dtype::int32> {};
+template <> struct dtype_of<std::int64_t> : std::integral_constant<dtype, dtype::int64> {};
+template <> struct dtype_of<std::uint8_t> : std::integral_constant<dtype, dtype::uint8> {};
+template <> struct dtype_of<std::uint16_t> : std::integral_constant<dtype, dtype::uint16> {};
+template <> struct dtype_of<std::uint32_t> : std::integral_constant<dtype, dtype::uint32> {};
+template <> struct dtype_of<std::uint64_t> : std::integral_constant<dtype, dtype::uint64> {};
+template <> struct dtype_of<float> : std::integral_constant<dtype, dtype::float32> {};
+template <> struct dtype_of<double> : std::integral_constant<dtype, dtype::float64> {};
+
+using dtype_switch =
+    integral_switch<dtype, dtype::int8, dtype::int16, dtype::int32, dtype::int64, dtype::uint8,
+                    dtype::uint16, dtype::uint32, dtype::uint64, dtype::float32, dtype::float64>;
+
+// The kinds of kernels: out[i] = apply(a[i]), out[i] = apply(a[i], b[i]), and
+// out[0] = combine(...combine(init(), a[0])..., a[n - 1]).
+struct unary_map {};
+struct binary_map {};
+struct reduction {};
+
+namespace detail {
+
+// Adds integers modulo 2^N, in the unsigned type so that signed overflow is not undefined.
+template <typename T> T wrapping_add(T a, T b, std::true_type) {
+    using unsigned_type = typename std::make_unsigned<T>::type;
+
+    return static_cast<T>(static_cast<unsigned_type>(a) + static_cast<unsigned_type>(b));
+}
+
+template <typename T> T wrapping_add(T a, T b, std::false_type) { return a + b; }
+
+template <typename T> T wrapping_add(T a, T b) {
+    return wrapping_add(a, b, std::is_integral<T>{});
+}
+
+// Converts a value to the type T. Floating point values outside the range of an integer T
+// saturate and NaN becomes 0, where static_cast would be undefined.
+template <typename T, typename W> T convert_result(W x, std::false_type) {
+    return static_cast<T>(x);
+}
+
+template <typename T, typename W> T convert_result(W x, std::true_type) {
+    return x != x                                               ? T(0)
+           : x <= static_cast<W>(std::numeric_limits<T>::min()) ? std::numeric_limits<T>::min()
+           : x >= static_cast<W>(std::numeric_limits<T>::max()) ? std::numeric_limits<T>::max()
+                                                                : static_cast<T>(x);
+}
+
+template <typename T, typename W> T convert_result(W x) {
+    using saturates = std::integral_constant<bool, std::is_floating_point<W>::value &&
+                                                       std::is_integral<T>::value>;
+
+    return convert_result<T>(x, saturates{});
+}
+
+} // namespace detail
+
+// Kernels for kernel_switch. Each has a kind, supports<In, Out> for the pairs of element types that
+// get a loop of their own, and apply<Out>(), or init<Out>() and combine<Out>() for reductions.
+struct cast_kernel {
+    using kind = unary_map;
+
+    template <typename In, typename Out> using supports = std::true_type;
+
+    // Floating point values saturate in integer outputs, as in the generic path.
+    template <typename Out, typename In> static Out apply(In a) {
+        return detail::convert_result<Out>(a);
+    }
+};
+
+struct add_kernel {
+    using kind = binary_map;
+
+    template <typename In, typename Out> using supports = std::is_same<In, Out>;
+
+    template <typename Out, typename In> static Out apply(In a, In b) {
+        return static_cast<Out>(detail::wrapping_add(a, b));
+    }
+};
+
+// Writes 1 where a[i] < b[i] and 0 elsewhere.
+struct less_kernel {
+    using kind = binary_map;
+
+    template <typename In, typename Out> using supports = std::is_same<Out, std::uint8_t>;
+
+    template <typename Out, typename In> static Out apply(In a, In b) {
+        return static_cast<Out>(a < b);
+    }
+};
+
+// Sums into the input type or into the widest type of its kind. Floating point sums are not
+// computed in the order of the elements; see kernel_loop().
+struct sum_kernel {
+    using kind = reduction;
+
+    template <typename In, typename Out>
+    using supports = std::integral_constant<
+        bool, std::is_same<In, Out>::value ||
+                  (std::is_floating_point<In>::value ? std::is_same<Out, double>::value
+                   : std::is_signed<In>::value       ? std::is_same<Out, std::int64_t>::value
+                                                     : std::is_same<Out, std::uint64_t>::value)>;
+
+    template <typename Out> static Out init() { return Out(0); }
+
+    template <typename Out, typename In> static Out combine(Out sum, In a) {
+        return detail::wrapping_add(sum, static_cast<Out>(a));
+    }
+};
+
+namespace detail {
+
+constexpr std::size_t dtype_count = 10;
+
+// The key of a pair of dtypes, or a key outside of dtype_pair_switch if either is not a dtype.
+constexpr std::size_t dtype_pair(dtype in, dtype out) {
+    return static_cast<std::size_t>(in) < dtype_count && static_cast<std::size_t>(out) < dtype_count
+               ? static_cast<std::size_t>(in) * dtype_count + static_cast<std::size_t>(out)
+               : dtype_count * dtype_count;
+}
+
+using dtype_pair_switch = make_integral_switch<make_index_sequence<dtype_count * dtype_count>>;
+
+template <std::size_t K>
+using pair_input = typename dtype_type<static_cast<dtype>(K / dtype_count)>::type;
+
+template <std::size_t K>
+using pair_output = typename dtype_type<static_cast<dtype>(K % dtype_count)>::type;
+
+// The loops of the kernels, which compilers vectorise for each pair of element types. Blocks of
+// kernel_block elements are computed into a local array, which the inputs cannot alias, and then
+// copied out, so that the loops are vectorised without runtime alias checks or loops for the
+// remainder, which GCC only emits from -O3 on. In place kernels, e.g. out == a, are fine.
+constexpr std::size_t kernel_block = 16;
+
+template <typename Kernel, typename In, typename Out>
+void kernel_loop(unary_map, const In *a, const In *, Out *out, std::size_t n) {
+    std::size_t i = 0;
+
+    for (; n - i >= kernel_block; i += kernel_block) {
+        Out r[kernel_block];
+
+        for (std::size_t j = 0; j < kernel_block; ++j) {
+            r[j] = Kernel::template apply<Out>(a[i + j]);
+        }
+        std::memcpy(out + i, r, sizeof(r));
+    }
+
+    for (; i < n; ++i) {
+        out[i] = Kernel::template apply<Out>(a[i]);
+    }
+}
+
+template <typename Kernel, typename In, typename Out>
+void kernel_loop(binary_map, const In *a, const In *b, Out *out, std::size_t n) {
+    std::size_t i = 0;
+
+    for (; n - i >= kernel_block; i += kernel_block) {
+        Out r[kernel_block];
+
+        for (std::size_t j = 0; j < kernel_block; ++j) {
+            r[j] = Kernel::template apply<Out>(a[i + j], b[i + j]);
+        }
+        std::memcpy(out + i, r, sizeof(r));
+    }
+
+    for (; i < n; ++i) {
+        out[i] = Kernel::template apply<Out>(a[i], b[i]);
+    }
+}
+
+// Reduces kernel_block interleaved partial results, which are combined at the end, so combine()
+// must be associative. Floating point addition is not, so float sums are reordered and may differ
+// in the last bits from the sequential sums of the generic path, as with any vectorised sum.
+template <typename Kernel, typename In, typename Out>
+void kernel_loop(reduction, const In *a, const In *, Out *out, std::size_t n) {
+    Out partial[kernel_block];
+    std::size_t i = 0;
+
+    for (std::size_t j = 0; j < kernel_block; ++j) {
+        partial[j] = Kernel::template init<Out>();
+    }
+
+    for (; n - i >= kernel_block; i += kernel_block) {
+        for (std::size_t j = 0; j < kernel_block; ++j) {
+            partial[j] = Kernel::template combine<Out>(partial[j], a[i + j]);
+        }
+    }
+
+    Out sum = Kernel::template init<Out>();
+
+    for (std::size_t j = 0; j < kernel_block; ++j) {
+        sum = Kernel::template combine<Out>(sum, partial[j]);
+    }
+
+    for (; i < n; ++i) {
+        sum = Kernel::template combine<Out>(sum, a[i]);
+    }
+    *out = sum;
+}
+
+// The type that the generic path computes in for inputs of type T, which holds every value of T:
+// int64_t for signed integers, uint64_t for unsigned ones and double for floating point.
+template <typename T>
+using generic_type = typename std::conditional<
+    std::is_floating_point<T>::value, double,
+    typename std::conditional<std::is_signed<T>::value, std::int64_t, std::uint64_t>::type>::type;
+
+template <typename W> struct load_chunk {
+    template <dtype D>
+    void operator()(std::integral_constant<dtype, D>, const void *data, std::size_t offset,
+                    W *chunk, std::size_t n) const {
+        const auto *typed = static_cast<const typename dtype_type<D>::type *>(data) + offset;
+
+        for (std::size_t i = 0; i < n; ++i) {
+            chunk[i] = static_cast<W>(typed[i]);
+        }
+    }
+};
+
+template <typename W> struct store_chunk {
+    template <dtype D>
+    void operator()(std::integral_constant<dtype, D>, const W *chunk, void *data,
+                    std::size_t offset, std::size_t n) const {
+        using T = typename dtype_type<D>::type;
+
+        T *typed = static_cast<T *>(data) + offset;
+
+        for (std::size_t i = 0; i < n; ++i) {
+            typed[i] = convert_result<T>(chunk[i]);
+        }
+    }
+};
+
+template <typename W> using load_function = void(const void *, std::size_t, W *, std::size_t);
+template <typename W> using store_function = void(const W *, void *, std::size_t, std::size_t);
+
+// The generic path converts chunks of the inputs to their generic_type W, runs the kernel on W and
+// converts the results to the output type. It is compiled once per kernel and W rather than once
+// per pair, and integers keep all their bits.
+template <typename Kernel, typename W, typename Kind>
+INTEGRAL_SWITCH_NOINLINE void generic_kernel(Kind, dtype in, dtype out, const void *a,
+                                             const void *b, void *result, std::size_t n) {
+    load_function<W> *load = dtype_switch::resolve<load_function<W>, load_chunk<W>>(in);
+    store_function<W> *store = dtype_switch::resolve<store_function<W>, store_chunk<W>>(out);
+
+    W x[INTEGRAL_SWITCH_KERNEL_CHUNK];
+    W y[INTEGRAL_SWITCH_KERNEL_CHUNK];
+    W r[INTEGRAL_SWITCH_KERNEL_CHUNK];
+
+    for (std::size_t offset = 0; offset < n; offset += INTEGRAL_SWITCH_KERNEL_CHUNK) {
+        const std::size_t m = n - offset < INTEGRAL_SWITCH_KERNEL_CHUNK
+                                  ? n - offset
+                                  : std::size_t(INTEGRAL_SWITCH_KERNEL_CHUNK);
+
+        load(a, offset, x, m);
+
+        if (std::is_same<Kind, binary_map>::value) {
+            load(b, offset, y, m);
+        }
+
+        kernel_loop<Kernel, W, W>(Kind{}, x, y, r, m);
+        store(r, result, offset, m);
+    }
+}
+
+template <typename Kernel, typename W>
+INTEGRAL_SWITCH_NOINLINE void generic_kernel(reduction, dtype in, dtype out, const void *a,
+                                             const void *, void *result, std::size_t n) {
+    load_function<W> *load = dtype_switch::resolve<load_function<W>, load_chunk<W>>(in);
+    store_function<W> *store = dtype_switch::resolve<store_function<W>, store_chunk<W>>(out);
+
+    W x[INTEGRAL_SWITCH_KERNEL_CHUNK];
+    W sum = Kernel::template init<W>();
+
+    for (std::size_t offset = 0; offset < n; offset += INTEGRAL_SWITCH_KERNEL_CHUNK) {
+        const std::size_t m = n - offset < INTEGRAL_SWITCH_KERNEL_CHUNK
+                                  ? n - offset
+                                  : std::size_t(INTEGRAL_SWITCH_KERNEL_CHUNK);
+
+        load(a, offset, x, m);
+
+        for (std::size_t i = 0; i < m; ++i) {
+            sum = Kernel::template combine<W>(sum, x[i]);
+        }
+    }
+    store(&sum, result, 0, 1);
+}
+
+// The case of a pair of dtypes that kernel_switch resolves to.
+template <typename Kernel> struct pair_kernel {
+    template <std::size_t K>
+    void operator()(std::integral_constant<std::size_t, K>, const void *a, const void *b,
+                    void *out, std::size_t n) const {
+        run(typename Kernel::template supports<pair_input<K>, pair_output<K>>{},
+            std::integral_constant<std::size_t, K>{}, a, b, out, n);
+    }
+
+    template <std::size_t K>
+    static void run(std::true_type, std::integral_constant<std::size_t, K>, const void *a,
+                    const void *b, void *out, std::size_t n) {
+        kernel_loop<Kernel>(typename Kernel::kind{}, static_cast<const pair_input<K> *>(a),
+                            static_cast<const pair_input<K> *>(b),
+                            static_cast<pair_output<K> *>(out), n);
+    }
+
+    template <std::size_t K>
+    static void run(std::false_type, std::integral_constant<std::size_t, K>, const void *a,
+                    const void *b, void *out, std::size_t n) {
+        generic_kernel<Kernel, generic_type<pair_input<K>>>(
+            typename Kernel::kind{}, static_cast<dtype>(K / dtype_count),
+            static_cast<dtype>(K % dtype_count), a, b, out, n);
+    }
+};
+
+template <typename Kernel> struct pair_supported {
+    template <std::size_t K> bool operator()(std::integral_constant<std::size_t, K>) const {
+        return Kernel::template supports<pair_input<K>, pair_output<K>>::value;
+    }
+};
+
+} // namespace detail
+
+// Runs a kernel on arrays whose element types are only known at run time. The pair of the input
+// and the output dtype is dispatched once per array, through a dense integral_switch over all
+// pairs, to a loop compiled for the pair when the kernel supports it, and to the generic path,
+// which converts through int64_t, uint64_t or double, otherwise. The inputs a and b have the input
+// dtype; b is only read by binary kernels, and reductions write one element.
+template <typename Kernel> class kernel_switch {
+  public:
+    using function = void(const void *a, const void *b, void *out, std::size_t n);
+
+    // The function for the pair, which can be called for any number of arrays.
+    static function *resolve(dtype in, dtype out) {
+        return detail::dtype_pair_switch::resolve<function, detail::pair_kernel<Kernel>>(
+            detail::dtype_pair(in, out));
+    }
+
+    // Whether the pair has a loop of its own rather than the generic path.
+    static bool specialised(dtype in, dtype out) {
+        return detail::dtype_pair_switch::visit_nothrow(detail::pair_supported<Kernel>{},
+                                                        detail::dtype_pair(in, out), false);
+    }
+
+    static void run(dtype in, dtype out, const void *a, const void *b, void *result,
+                    std::size_t n) {
+        resolve(in, out)(a, b, result, n);
+    }
+};
+
+} // namespace integral_switch
+
+#endif
@@ -0,0 +1,188 @@
+/*
+ * mpsc_queue.h
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MPSC_QUEUE_H_
+#define MPSC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "integral_switch.h"
+
+namespace integral_switch {
+
+namespace detail {
+
+// Every record of an mpsc_queue starts with a header in one unit of the buffer; the payload fills
+// the units that follow. A size of 0 marks a record that is not yet published.
+struct alignas(16) record_header {
+    std::atomic<std::uint32_t> size{0};
+    std::uint32_t tag = 0;
+};
+
+constexpr std::size_t record_units(std::size_t payload_size) {
+    return 1 + (payload_size + sizeof(record_header) - 1) / sizeof(record_header);
+}
+
+// Calls the visitor with the payload of a record and destroys the payload afterwards.
+template <typename Visitor> struct record_visitor {
+    Visitor &visitor;
+    void *payload;
+
+    template <typename U> INTEGRAL_SWITCH_ALWAYS_INLINE void operator()(type<U>) const {
+        U &value = *static_cast<U *>(payload);
+
+        visitor(value);
+        value.~U();
+    }
+};
+
+struct discard_message {
+    template <typename U> void operator()(U &) const {}
+};
+
+} // namespace detail
+
+// A bounded multi-producer single-consumer queue of messages of the types Ts. Producers construct
+// messages in place in a ring buffer of Capacity bytes, tagged with the position of their type in
+// Ts. The consumer drains them in batches and dispatches every message on its tag through a
+// variadic_switch, so the payloads are never copied and need no virtual functions. Records are
+// whole multiples of 16 bytes and never wrap around the end of the buffer.
+template <std::size_t Capacity, typename... Ts> class mpsc_queue {
+    using header = detail::record_header;
+
+    static constexpr std::size_t units = Capacity / sizeof(header);
+    static constexpr std::uint32_t padding_tag = sizeof...(Ts);
+
+    static_assert(Capacity >= sizeof(header) && (Capacity & (Capacity - 1)) == 0,
+                  "the capacity must be a power of two");
+    static_assert(units <= std::numeric_limits<std::uint32_t>::max(), "the capacity is too large");
+
+    alignas(INTEGRAL_SWITCH_CACHE_LINE_SIZE) std::atomic<std::uint64_t> tail_{0};
+    alignas(INTEGRAL_SWITCH_CACHE_LINE_SIZE) std::atomic<std::uint64_t> head_{0};
+    alignas(INTEGRAL_SWITCH_CACHE_LINE_SIZE) header buffer_[units];
+
+    // Returns the first unit of a record of n units, or nullptr if the queue is full. A record that
+    // would cross the end of the buffer is preceded by a padding record up to the end.
+    header *reserve(std::size_t n) {
+        std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        std::size_t padding;
+
+        do {
+            const std::size_t offset = tail % units;
+
+            padding = offset + n > units ? units - offset : 0;
+
+            if (tail + padding + n - head_.load(std::memory_order_acquire) > units) {
+                return nullptr;
+            }
+        } while (!tail_.compare_exchange_weak(tail, tail + padding + n, std::memory_order_relaxed));
+
+        if (padding != 0) {
+            publish(&buffer_[tail % units], padding, padding_tag);
+        }
+        return &buffer_[(tail + padding) % units];
+    }
+
+    static void publish(header *record, std::size_t n, std::uint32_t tag) {
+        record->tag = tag;
+        record->size.store(static_cast<std::uint32_t>(n), std::memory_order_release);
+    }
+
+  public:
+    mpsc_queue() = default;
+
+    mpsc_queue(const mpsc_queue &) = delete;
+    mpsc_queue &operator=(const mpsc_queue &) = delete;
+
+    ~mpsc_queue() { consume(detail::discard_message{}); }
+
+    // Constructs a U from args in the queue. Returns false if the queue is full.
+    template <typename U, typename... Args> bool try_emplace(Args &&... args) {
+        static_assert(alignof(U) <= sizeof(header), "the message type is over-aligned");
+
+        constexpr std::size_t n = detail::record_units(sizeof(U));
+        static_assert(n <= units, "the message type is larger than the queue");
+
+        header *record = reserve(n);
+
+        if (record == nullptr) {
+            return false;
+        }
+
+#ifdef USE_CPP_EXCEPTIONS
+        try {
+            new (record + 1) U(std::forward<Args>(args)...);
+        } catch (...) {
+            publish(record, n, padding_tag);
+            throw;
+        }
+#else
+        new (record + 1) U(std::forward<Args>(args)...);
+#endif
+
+        publish(record, n, static_cast<std::uint32_t>(detail::type_index<U, Ts...>::value));
+        return true;
+    }
+
+    template <typename U> bool try_push(U &&message) {
+        return try_emplace<typename std::decay<U>::type>(std::forward<U>(message));
+    }
+
+    // Calls visitor(message) for up to max messages in the order they were published and destroys
+    // them. Stops early at a record whose producer has not finished. The visitor must not throw.
+    // Returns the number of messages visited. Must only be called by one thread at a time.
+    template <typename Visitor>
+    std::size_t consume(Visitor &&visitor,
+                        std::size_t max = std::numeric_limits<std::size_t>::max()) {
+        std::uint64_t head = head_.load(std::memory_order_relaxed);
+        std::size_t count = 0;
+
+        while (count < max) {
+            header *record = &buffer_[head % units];
+            const std::size_t n = record->size.load(std::memory_order_acquire);
+
+            if (n == 0) {
+                break;
+            }
+
+            if (record->tag != padding_tag) {
+                variadic_switch<Ts...>::visit_unchecked(
+                    detail::record_visitor<Visitor>{visitor, record + 1}, record->tag);
+                ++count;
+            }
+
+            for (std::size_t i = 0; i < n; ++i) {
+                new (record + i) header();
+            }
+            head += n;
+        }
+
+        head_.store(head, std::memory_order_release);
+        return count;
+    }
+};
+
+} // namespace integral_switch
+
+#endif
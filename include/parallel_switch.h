@@ -0,0 +1,299 @@
+/*
+ * parallel_switch.h
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARALLEL_SWITCH_H_
+#define PARALLEL_SWITCH_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "integral_switch.h"
+
+// Number of keys visit_batch_parallel() hands to a worker at a time.
+#ifndef INTEGRAL_SWITCH_BATCH_CHUNK
+#define INTEGRAL_SWITCH_BATCH_CHUNK 4096
+#endif
+
+namespace integral_switch {
+
+namespace detail {
+
+// A range of task indices [begin, end) packed into one word. The owner takes tasks from the front,
+// other workers steal the back half. Padded rather than aligned, since before C++17 new ignores
+// extended alignment.
+struct task_range {
+    std::atomic<std::uint64_t> bounds{0};
+    unsigned char padding[INTEGRAL_SWITCH_CACHE_LINE_SIZE - sizeof(std::atomic<std::uint64_t>)];
+
+    static constexpr std::uint64_t pack(std::uint64_t begin, std::uint64_t end) {
+        return begin << 32 | end;
+    }
+
+    static constexpr std::size_t begin(std::uint64_t b) {
+        return static_cast<std::size_t>(b >> 32);
+    }
+
+    static constexpr std::size_t end(std::uint64_t b) {
+        return static_cast<std::size_t>(b & 0xffffffffu);
+    }
+
+    bool pop_front(std::size_t &task) {
+        std::uint64_t b = bounds.load(std::memory_order_relaxed);
+
+        do {
+            if (begin(b) >= end(b)) {
+                return false;
+            }
+        } while (!bounds.compare_exchange_weak(b, pack(begin(b) + 1, end(b))));
+
+        task = begin(b);
+        return true;
+    }
+
+    bool steal_back(std::size_t &first, std::size_t &last) {
+        std::uint64_t b = bounds.load(std::memory_order_relaxed);
+        std::size_t half;
+
+        do {
+            if (begin(b) >= end(b)) {
+                return false;
+            }
+            half = (end(b) - begin(b) + 1) / 2;
+        } while (!bounds.compare_exchange_weak(b, pack(begin(b), end(b) - half)));
+
+        first = end(b) - half;
+        last = end(b);
+        return true;
+    }
+};
+
+template <typename Visitor> struct padded_visitor {
+    Visitor visitor;
+    unsigned char padding[INTEGRAL_SWITCH_CACHE_LINE_SIZE];
+};
+
+template <typename Visitor>
+auto merge_visitor(Visitor &into, Visitor &from, int) -> decltype(into.merge(from), void()) {
+    into.merge(from);
+}
+
+template <typename Visitor> void merge_visitor(Visitor &, Visitor &, long) {}
+
+// Calls visitor(key, index), so that the visitor can find the record the key belongs to.
+template <typename Visitor> struct indexed_visitor {
+    Visitor &visitor;
+    std::size_t index;
+
+    template <typename K> void operator()(K key) { visitor(key, index); }
+};
+
+} // namespace detail
+
+// A fixed set of threads that run parallel_for() jobs. Every job is split into one range of tasks
+// per worker; a worker that runs out of tasks steals half of the remaining tasks of another one.
+class work_stealing_pool {
+    using job_type = void (*)(void *, std::size_t worker, std::size_t task);
+
+    std::unique_ptr<detail::task_range[]> ranges_;
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::uint64_t generation_ = 0;
+    bool stopping_ = false;
+
+    job_type job_ = nullptr;
+    void *context_ = nullptr;
+    std::atomic<std::size_t> running_{0};
+
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+
+    void run_tasks(std::size_t worker) {
+        const std::size_t workers = size();
+        std::size_t task, first, last;
+
+        for (;;) {
+            while (ranges_[worker].pop_front(task)) {
+                call(worker, task);
+            }
+
+            bool stolen = false;
+
+            for (std::size_t i = 1; i < workers && !stolen; ++i) {
+                stolen = ranges_[(worker + i) % workers].steal_back(first, last);
+            }
+
+            if (!stolen) {
+                return;
+            }
+
+            call(worker, first);
+            ranges_[worker].bounds.store(detail::task_range::pack(first + 1, last));
+        }
+    }
+
+    void call(std::size_t worker, std::size_t task) {
+#ifdef USE_CPP_EXCEPTIONS
+        try {
+            job_(context_, worker, task);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex_);
+
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+#else
+        job_(context_, worker, task);
+#endif
+    }
+
+    void run_thread(std::size_t worker) {
+        std::uint64_t seen = 0;
+
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+
+                wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+
+                if (stopping_) {
+                    return;
+                }
+                seen = generation_;
+            }
+
+            run_tasks(worker);
+            running_.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    template <typename F> static void call_job(void *f, std::size_t worker, std::size_t task) {
+        (*static_cast<F *>(f))(worker, task);
+    }
+
+  public:
+    // The calling thread of parallel_for() takes part as worker 0, so threads - 1 threads are
+    // started.
+    explicit work_stealing_pool(std::size_t threads = std::thread::hardware_concurrency())
+        : ranges_(new detail::task_range[std::max<std::size_t>(threads, 1)]) {
+        for (std::size_t i = 1; i < threads; ++i) {
+            threads_.emplace_back(&work_stealing_pool::run_thread, this, i);
+        }
+    }
+
+    work_stealing_pool(const work_stealing_pool &) = delete;
+    work_stealing_pool &operator=(const work_stealing_pool &) = delete;
+
+    ~work_stealing_pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            stopping_ = true;
+        }
+        wake_.notify_all();
+
+        for (auto &thread : threads_) {
+            thread.join();
+        }
+    }
+
+    // Number of workers, including the calling thread of parallel_for().
+    std::size_t size() const { return threads_.size() + 1; }
+
+    // Calls f(worker, task) for every task in [0, n) and waits until all calls returned. The first
+    // exception thrown by f is rethrown. Must not be called concurrently.
+    template <typename F> void parallel_for(std::size_t n, F &&f) {
+        using function_type = typename std::remove_reference<F>::type;
+
+        const std::size_t workers = size();
+
+        for (std::size_t i = 0; i < workers; ++i) {
+            ranges_[i].bounds.store(
+                detail::task_range::pack(n * i / workers, n * (i + 1) / workers));
+        }
+
+        job_ = &call_job<function_type>;
+        context_ = const_cast<void *>(static_cast<const void *>(&f));
+        error_ = nullptr;
+        running_.store(workers - 1);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        run_tasks(0);
+
+        while (running_.load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+};
+
+// Visits every key of keys[0, n) with Switch::visit(), spread over the workers of the pool in
+// chunks of chunk_size keys. The visitor is called as visitor(key, i) with the position i of the
+// key, so keys can be a projection of an array of records. Every worker visits with its own copy
+// of the visitor, so any state it accumulates should start out empty. Afterwards the copies are
+// merged into the first one with copy.merge(other) if the visitor has such a member, and the
+// merged visitor is returned.
+template <typename Switch, typename Visitor, typename Key>
+Visitor visit_batch_parallel(const Visitor &visitor, const Key *keys, std::size_t n,
+                             work_stealing_pool &pool,
+                             std::size_t chunk_size = INTEGRAL_SWITCH_BATCH_CHUNK) {
+    using padded = detail::padded_visitor<Visitor>;
+
+    std::vector<padded> visitors(pool.size(), padded{visitor, {}});
+
+    auto visit_chunk = [&](std::size_t worker, std::size_t chunk) {
+        Visitor &v = visitors[worker].visitor;
+        const std::size_t last = std::min(n, (chunk + 1) * chunk_size);
+
+        for (std::size_t i = chunk * chunk_size; i < last; ++i) {
+            Switch::visit(detail::indexed_visitor<Visitor>{v, i}, keys[i]);
+        }
+    };
+
+    pool.parallel_for((n + chunk_size - 1) / chunk_size, visit_chunk);
+
+    for (std::size_t i = 1; i < visitors.size(); ++i) {
+        detail::merge_visitor(visitors[0].visitor, visitors[i].visitor, 0);
+    }
+
+    return std::move(visitors[0].visitor);
+}
+
+} // namespace integral_switch
+
+#endif
@@ -0,0 +1,421 @@
+/*
+ * pattern_switch.h
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PATTERN_SWITCH_H_
+#define PATTERN_SWITCH_H_
+
+#include <cstddef>
+#include <limits>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "integral_switch.h"
+
+// The widest field of bits a node of the decision tree of a pattern_switch switches on.
+#ifndef INTEGRAL_SWITCH_PATTERN_FIELD_BITS
+#define INTEGRAL_SWITCH_PATTERN_FIELD_BITS 8
+#endif
+
+// The decision tree is built with C++14 constexpr functions.
+#ifdef USE_CPP_14_CONSTEXPR
+
+namespace integral_switch {
+
+// The values x with (x & mask) == value. Bits outside of the mask are don't-care bits.
+template <typename T, T Mask, T Value> struct pattern {
+    static_assert(std::is_unsigned<T>::value, "patterns must be of unsigned integers");
+    static_assert((Value & ~Mask) == 0, "the value of a pattern must be within its mask");
+
+    using value_type = T;
+
+    static constexpr T mask = Mask;
+    static constexpr T value = Value;
+
+    static constexpr bool matches(T x) { return (x & Mask) == Value; }
+};
+
+template <typename T, T Mask, T Value> constexpr T pattern<T, Mask, Value>::mask;
+template <typename T, T Mask, T Value> constexpr T pattern<T, Mask, Value>::value;
+
+namespace detail {
+
+template <typename Out, typename In, typename Keep> struct filter_sequence; // undefined
+
+template <std::size_t... Os>
+struct filter_sequence<index_sequence<Os...>, index_sequence<>, bool_sequence<>> {
+    using type = index_sequence<Os...>;
+};
+
+template <std::size_t... Os, std::size_t I, std::size_t... Is, bool K, bool... Ks>
+struct filter_sequence<index_sequence<Os...>, index_sequence<I, Is...>, bool_sequence<K, Ks...>>
+    : filter_sequence<typename std::conditional<K, index_sequence<Os..., I>,
+                                                index_sequence<Os...>>::type,
+                      index_sequence<Is...>, bool_sequence<Ks...>> {};
+
+// The test of a node of the decision tree: a field of bits that every pattern of the node cares
+// about, or a single bit that some of them do not care about.
+struct pattern_split {
+    bool field;
+    unsigned shift;
+    unsigned bits;
+};
+
+// Prefers the widest run of bits that all patterns care about and that tells at least two of them
+// apart. Without such bits, takes the bit that sends the most patterns to the smaller side.
+template <typename T>
+constexpr pattern_split choose_split(const T *masks, const T *values, std::size_t n) {
+    constexpr unsigned width = std::numeric_limits<T>::digits;
+
+    T common = static_cast<T>(~T(0));
+    T any_set = 0;
+    T all_set = static_cast<T>(~T(0));
+
+    for (std::size_t i = 0; i < n; ++i) {
+        common &= masks[i];
+        any_set |= values[i];
+        all_set &= values[i];
+    }
+
+    const T differing = static_cast<T>(common & any_set & ~all_set);
+
+    pattern_split best{true, 0, 0};
+
+    for (unsigned b = 0; b < width;) {
+        unsigned run = 0;
+
+        while (b + run < width && run < INTEGRAL_SWITCH_PATTERN_FIELD_BITS &&
+               ((differing >> (b + run)) & 1) != 0) {
+            ++run;
+        }
+
+        if (run > best.bits) {
+            best = pattern_split{true, b, run};
+        }
+        b += run == 0 ? 1 : run;
+    }
+
+    if (best.bits != 0) {
+        return best;
+    }
+
+    std::size_t best_score = 0;
+
+    for (unsigned b = 0; b < width; ++b) {
+        std::size_t zeros = 0;
+        std::size_t ones = 0;
+
+        for (std::size_t i = 0; i < n; ++i) {
+            if (((masks[i] >> b) & 1) == 0) {
+                continue;
+            }
+
+            if (((values[i] >> b) & 1) != 0) {
+                ++ones;
+            } else {
+                ++zeros;
+            }
+        }
+
+        const std::size_t score = zeros < ones ? zeros : ones;
+
+        if (score > best_score) {
+            best_score = score;
+            best = pattern_split{false, b, 1};
+        }
+    }
+    return best;
+}
+
+template <typename T> constexpr T field_of(T x, pattern_split split) {
+    return static_cast<T>((x >> split.shift) & ((T(1) << split.bits) - 1));
+}
+
+// The distinct values of a field among the patterns, in ascending order.
+template <typename T> struct field_values {
+    T values[std::size_t(1) << INTEGRAL_SWITCH_PATTERN_FIELD_BITS];
+    std::size_t count;
+};
+
+template <typename T>
+constexpr field_values<T> collect_fields(const T *values, std::size_t n, pattern_split split) {
+    bool present[std::size_t(1) << INTEGRAL_SWITCH_PATTERN_FIELD_BITS] = {};
+    field_values<T> fields{{}, 0};
+
+    for (std::size_t i = 0; i < n; ++i) {
+        present[field_of(values[i], split)] = true;
+    }
+
+    for (std::size_t f = 0; f < (std::size_t(1) << split.bits); ++f) {
+        if (present[f]) {
+            fields.values[fields.count++] = static_cast<T>(f);
+        }
+    }
+    return fields;
+}
+
+// The position i * n + j of the first two patterns i < j that match a common value, or n * n.
+template <typename T>
+constexpr std::size_t find_overlap(const T *masks, const T *values, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = i + 1; j < n; ++j) {
+            if (((values[i] ^ values[j]) & masks[i] & masks[j]) == 0) {
+                return i * n + j;
+            }
+        }
+    }
+    return n * n;
+}
+
+template <typename P, typename Q> struct ambiguous_patterns {
+    static_assert(!std::is_same<P, P>::value,
+                  "two patterns of a pattern_switch match the same value");
+    static constexpr bool value = false;
+};
+
+// The pattern at the position I of the std::tuple Patterns, which only serves as a list of types.
+template <std::size_t I, typename Patterns> struct pattern_type_at_impl; // undefined
+
+template <std::size_t I, typename... Ps> struct pattern_type_at_impl<I, std::tuple<Ps...>> {
+    using type = type_at<I, Ps...>;
+};
+
+template <std::size_t I, typename Patterns>
+using pattern_type_at = typename pattern_type_at_impl<I, Patterns>::type;
+
+template <typename Patterns, std::size_t Overlap, std::size_t N = std::tuple_size<Patterns>::value,
+          bool Disjoint = Overlap == N * N>
+struct check_patterns
+    : ambiguous_patterns<pattern_type_at<Overlap / N, Patterns>,
+                         pattern_type_at<Overlap % N, Patterns>> {};
+
+template <typename Patterns, std::size_t Overlap, std::size_t N>
+struct check_patterns<Patterns, Overlap, N, true> {
+    static constexpr bool value = true;
+};
+
+// A node of the decision tree over the patterns of the tuple Patterns at the positions Set.
+template <typename Patterns, typename Set> struct pattern_node; // undefined
+
+template <typename Patterns> struct pattern_node<Patterns, index_sequence<>> {
+    template <typename Ret, typename Visitor, typename T, typename Miss>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&, T x, Miss &&miss) {
+        return std::forward<Miss>(miss)(x);
+    }
+};
+
+template <typename Patterns, std::size_t I> struct pattern_node<Patterns, index_sequence<I>> {
+    using pattern_type = pattern_type_at<I, Patterns>;
+
+    template <typename Ret, typename Visitor, typename T, typename Miss>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T x, Miss &&miss) {
+        if (pattern_type::matches(x)) {
+            return std::forward<Visitor>(visitor)(pattern_type{});
+        }
+        return std::forward<Miss>(miss)(x);
+    }
+};
+
+template <typename Ret, typename Visitor, typename T, typename Miss, typename Node>
+struct field_case {
+    Visitor &&visitor;
+    T x;
+    Miss &&miss;
+
+    template <T f>
+    INTEGRAL_SWITCH_ALWAYS_INLINE Ret operator()(std::integral_constant<T, f>) const {
+        return Node::template child<f>::template dispatch<Ret>(std::forward<Visitor>(visitor), x,
+                                                               std::forward<Miss>(miss));
+    }
+};
+
+template <typename Ret, typename T, typename Miss> struct field_miss {
+    T x;
+    Miss &&miss;
+
+    Ret operator()(T) const { return std::forward<Miss>(miss)(x); }
+};
+
+template <typename Patterns, std::size_t I0, std::size_t I1, std::size_t... Is>
+struct pattern_node<Patterns, index_sequence<I0, I1, Is...>> {
+    using set = index_sequence<I0, I1, Is...>;
+
+    template <std::size_t I> using pattern_at = pattern_type_at<I, Patterns>;
+
+    using T = typename pattern_at<I0>::value_type;
+    using masks = key_array<T, pattern_at<I0>::mask, pattern_at<I1>::mask, pattern_at<Is>::mask...>;
+    using values =
+        key_array<T, pattern_at<I0>::value, pattern_at<I1>::value, pattern_at<Is>::value...>;
+
+    static constexpr pattern_split split =
+        choose_split(masks::values, values::values, sizeof...(Is) + 2);
+
+    static constexpr field_values<T> fields =
+        collect_fields(values::values, sizeof...(Is) + 2, split);
+
+    // The patterns whose field equals f.
+    template <T f>
+    using child = pattern_node<
+        Patterns,
+        typename filter_sequence<index_sequence<>, set,
+                                 bool_sequence<field_of(pattern_at<I0>::value, split) == f,
+                                               field_of(pattern_at<I1>::value, split) == f,
+                                               (field_of(pattern_at<Is>::value, split) ==
+                                                f)...>>::type>;
+
+    // The patterns that match values whose bit is set, or clear.
+    template <bool Set, std::size_t I>
+    using keeps_bit = std::integral_constant<
+        bool, ((pattern_at<I>::mask >> split.shift) & 1) == 0 ||
+                  (((pattern_at<I>::value >> split.shift) & 1) != 0) == Set>;
+
+    template <bool Set>
+    using bit_child = pattern_node<
+        Patterns, typename filter_sequence<index_sequence<>, set,
+                                           bool_sequence<keeps_bit<Set, I0>::value,
+                                                         keeps_bit<Set, I1>::value,
+                                                         keeps_bit<Set, Is>::value...>>::type>;
+
+    template <typename Seq> struct field_switch; // undefined
+
+    template <std::size_t... Ks> struct field_switch<index_sequence<Ks...>> {
+        using type = integral_switch<T, fields.values[Ks]...>;
+    };
+
+    template <typename Ret, typename Visitor, typename Miss>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_split(std::true_type, Visitor &&visitor, T x,
+                                                            Miss &&miss) {
+        using switch_type = typename field_switch<make_index_sequence<fields.count>>::type;
+
+        field_case<Ret, Visitor, T, Miss, pattern_node> cases{std::forward<Visitor>(visitor), x,
+                                                             std::forward<Miss>(miss)};
+        field_miss<Ret, T, Miss> fallback{x, std::forward<Miss>(miss)};
+
+        return switch_type::visit_or(cases, field_of(x, split), fallback);
+    }
+
+    template <typename Ret, typename Visitor, typename Miss>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch_split(std::false_type, Visitor &&visitor, T x,
+                                                            Miss &&miss) {
+        if (((x >> split.shift) & 1) != 0) {
+            return bit_child<true>::template dispatch<Ret>(std::forward<Visitor>(visitor), x,
+                                                           std::forward<Miss>(miss));
+        }
+        return bit_child<false>::template dispatch<Ret>(std::forward<Visitor>(visitor), x,
+                                                        std::forward<Miss>(miss));
+    }
+
+    template <typename Ret, typename Visitor, typename U, typename Miss>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, U x, Miss &&miss) {
+        return dispatch_split<Ret>(std::integral_constant<bool, split.field>{},
+                                   std::forward<Visitor>(visitor), static_cast<T>(x),
+                                   std::forward<Miss>(miss));
+    }
+};
+
+template <typename Patterns, std::size_t I0, std::size_t I1, std::size_t... Is>
+constexpr pattern_split pattern_node<Patterns, index_sequence<I0, I1, Is...>>::split;
+
+template <typename Patterns, std::size_t I0, std::size_t I1, std::size_t... Is>
+constexpr field_values<typename pattern_node<Patterns, index_sequence<I0, I1, Is...>>::T>
+    pattern_node<Patterns, index_sequence<I0, I1, Is...>>::fields;
+
+} // namespace detail
+
+// Dispatches on the first of the patterns that matches the value, e.g. on the encodings of the
+// instructions of an ISA, and calls the visitor with that pattern. No two patterns may match the
+// same value, which is checked at compile time. The patterns are matched with a decision tree
+// that is built at compile time: every node switches with an integral_switch on the widest field
+// of bits that all of its patterns care about and that tells some of them apart, or else tests
+// the single bit that splits them most evenly. A leaf checks the whole pattern.
+template <typename... Patterns> class pattern_switch {
+    static_assert(sizeof...(Patterns) > 0, "a pattern_switch needs at least one pattern");
+
+    using T = typename detail::first_t<Patterns...>::value_type;
+    using patterns = std::tuple<Patterns...>;
+
+    static_assert(detail::all<std::is_same<T, typename Patterns::value_type>::value...>::value,
+                  "the patterns of a pattern_switch must have the same type");
+
+    static_assert(
+        detail::check_patterns<patterns, detail::find_overlap(
+                                             detail::key_array<T, Patterns::mask...>::values,
+                                             detail::key_array<T, Patterns::value...>::values,
+                                             sizeof...(Patterns))>::value,
+        "the patterns of a pattern_switch must be disjoint");
+
+    using tree = detail::pattern_node<patterns, detail::index_sequence_for<Patterns...>>;
+
+    template <typename Visitor, typename P>
+    using return_type_of = decltype(std::declval<Visitor>()(P{}));
+
+    template <typename Ret, typename Visitor, typename Miss>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, T x, Miss &&miss) {
+        static_assert(
+            detail::all<std::is_same<Ret, return_type_of<Visitor, Patterns>>::value...>::value,
+            "All return types must be equal");
+
+        return tree::template dispatch<Ret>(std::forward<Visitor>(visitor), x,
+                                            std::forward<Miss>(miss));
+    }
+
+  public:
+    template <typename Visitor>
+    using return_type = return_type_of<Visitor, detail::first_t<Patterns...>>;
+
+    template <typename Policy = typename miss_policy<pattern_switch>::type, typename Visitor>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor> visit(Visitor &&visitor, T value) {
+        return dispatch<return_type<Visitor>>(
+            std::forward<Visitor>(visitor), value,
+            detail::policy_on_miss<return_type<Visitor>, Policy>{});
+    }
+
+    // Sets ec instead of applying the miss policy when no pattern matches, and then returns a
+    // value initialised result.
+    template <typename Visitor>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor> visit(Visitor &&visitor, T value,
+                                                                    std::error_code &ec) {
+        ec.clear();
+        return dispatch<return_type<Visitor>>(std::forward<Visitor>(visitor), value,
+                                              detail::error_on_miss<return_type<Visitor>>{ec});
+    }
+
+    template <typename Visitor, typename R>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor>
+    visit_nothrow(Visitor &&visitor, T value, R &&default_ret) {
+        return dispatch<return_type<Visitor>>(
+            std::forward<Visitor>(visitor), value,
+            detail::return_on_miss<return_type<Visitor>, R>{std::forward<R>(default_ret)});
+    }
+
+    // Returns fallback(value) when no pattern matches.
+    template <typename Visitor, typename F>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor> visit_or(Visitor &&visitor, T value,
+                                                                       F &&fallback) {
+        return dispatch<return_type<Visitor>>(
+            std::forward<Visitor>(visitor), value,
+            detail::call_on_miss<return_type<Visitor>, F>{std::forward<F>(fallback)});
+    }
+};
+
+} // namespace integral_switch
+
+#endif
+
+#endif
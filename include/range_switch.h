@@ -0,0 +1,187 @@
+/*
+ * range_switch.h
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef RANGE_SWITCH_H_
+#define RANGE_SWITCH_H_
+
+#include <cstddef>
+#include <limits>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "integral_switch.h"
+
+// Range switches with up to this many bounds count the bounds below the value with a branchless
+// linear scan, which compilers vectorise. Larger ones use a branchless binary search. With wider
+// vectors than SSE2, e.g. -mavx2, the scan pays off for more bounds.
+#ifndef INTEGRAL_SWITCH_RANGE_LINEAR
+#define INTEGRAL_SWITCH_RANGE_LINEAR 16
+#endif
+
+namespace integral_switch {
+
+namespace detail {
+
+// The bounds followed by padding up to a multiple of 32 bytes. The padding is the smallest value of
+// T, which no value is less than.
+template <typename T, typename Seq, T... bounds> struct padded_bounds; // undefined
+
+template <typename T, std::size_t... Is, T... bounds>
+struct padded_bounds<T, index_sequence<Is...>, bounds...> {
+    static constexpr T values[sizeof...(bounds) + sizeof...(Is)] = {
+        bounds..., (static_cast<void>(Is), std::numeric_limits<T>::min())...};
+};
+
+template <typename T, std::size_t... Is, T... bounds>
+constexpr T padded_bounds<T, index_sequence<Is...>, bounds...>::values[sizeof...(bounds) +
+                                                                       sizeof...(Is)];
+
+template <typename T, T... bounds>
+using padded_bounds_t =
+    padded_bounds<T,
+                  make_index_sequence<(sizeof...(bounds) + 32 / sizeof(T) - 1) / (32 / sizeof(T)) *
+                                          (32 / sizeof(T)) -
+                                      sizeof...(bounds)>,
+                  bounds...>;
+
+// The number of bounds that are less than or equal to the value, from the number of padded bounds
+// that are greater. Every bound is compared, without an early exit, and the trip count is a
+// multiple of the vector width, so that compilers vectorise the loop into compares and adds.
+template <typename T, std::size_t N, std::size_t P>
+INTEGRAL_SWITCH_ALWAYS_INLINE std::size_t count_bounds_linear(const T (&bounds)[P], T value) {
+    typename std::make_unsigned<T>::type greater = 0;
+
+    for (std::size_t i = 0; i < P; ++i) {
+        greater += static_cast<typename std::make_unsigned<T>::type>(value < bounds[i]);
+    }
+    return N - greater;
+}
+
+// The same count by halving the bounds N times with conditional moves.
+template <typename T, std::size_t N>
+INTEGRAL_SWITCH_ALWAYS_INLINE std::size_t count_bounds_binary(const T (&bounds)[N], T value) {
+    const T *first = bounds;
+
+    for (std::size_t n = N; n > 1;) {
+        const std::size_t half = n / 2;
+
+        first = first[half] <= value ? first + half : first;
+        n -= half;
+    }
+    return static_cast<std::size_t>(first - bounds) + static_cast<std::size_t>(*first <= value);
+}
+
+template <typename Ret, typename U, typename Miss> struct range_miss {
+    U &&value;
+    Miss &&miss;
+
+    Ret operator()(std::size_t) const { return miss(std::forward<U>(value)); }
+};
+
+} // namespace detail
+
+// Classifies values by the half-open intervals [b0, b1), [b1, b2), ... between ascending bounds,
+// e.g. range_switch<int, 0, 10, 100> has the intervals [0, 10) and [10, 100). The visitor is called
+// with the index of the interval of the value as std::integral_constant<std::size_t, I>. Values
+// below the first or from the last bound on are misses. Values are converted to T. The index is
+// the number of bounds up to the value, which is counted without branches, and is dispatched with
+// an integral_switch.
+template <typename T, T... bounds> class range_switch {
+    static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value,
+                  "the bounds of a range_switch must be integers");
+    static_assert(sizeof...(bounds) > 1, "a range_switch needs at least two bounds");
+    static_assert(detail::ascending_keys<T, bounds...>::value,
+                  "the bounds of a range_switch must be ascending");
+
+    using index_switch = make_integral_switch<detail::make_index_sequence<sizeof...(bounds) - 1>>;
+
+    static INTEGRAL_SWITCH_ALWAYS_INLINE std::size_t count(T value) {
+        return sizeof...(bounds) <= INTEGRAL_SWITCH_RANGE_LINEAR
+                   ? detail::count_bounds_linear<T, sizeof...(bounds)>(
+                         detail::padded_bounds_t<T, bounds...>::values, value)
+                   : detail::count_bounds_binary(detail::key_array<T, bounds...>::values, value);
+    }
+
+    template <typename Ret, typename Visitor, typename U, typename Miss>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, U &&value, Miss &&miss) {
+        // Values below the first bound wrap around to a large index, which is a miss as well.
+        const std::size_t index = count(static_cast<T>(value)) - 1;
+
+        detail::range_miss<Ret, U, Miss> fallback{std::forward<U>(value),
+                                                  std::forward<Miss>(miss)};
+
+        return index_switch::visit_or(std::forward<Visitor>(visitor), index, fallback);
+    }
+
+  public:
+    // The number of intervals.
+    static constexpr std::size_t size = sizeof...(bounds) - 1;
+
+    template <typename Visitor>
+    using return_type = typename index_switch::template return_type<Visitor>;
+
+    template <typename Policy = typename miss_policy<range_switch>::type, typename Visitor,
+              typename U>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor> visit(Visitor &&visitor, U &&value) {
+        return dispatch<return_type<Visitor>>(
+            std::forward<Visitor>(visitor), std::forward<U>(value),
+            detail::policy_on_miss<return_type<Visitor>, Policy>{});
+    }
+
+    // Sets ec instead of applying the miss policy when the value is in no interval, and then
+    // returns a value initialised result.
+    template <typename Visitor, typename U>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor> visit(Visitor &&visitor, U &&value,
+                                                                    std::error_code &ec) {
+        ec.clear();
+        return dispatch<return_type<Visitor>>(std::forward<Visitor>(visitor),
+                                              std::forward<U>(value),
+                                              detail::error_on_miss<return_type<Visitor>>{ec});
+    }
+
+    template <typename Visitor, typename U, typename R>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor>
+    visit_nothrow(Visitor &&visitor, U &&value, R &&default_ret) {
+        return dispatch<return_type<Visitor>>(
+            std::forward<Visitor>(visitor), std::forward<U>(value),
+            detail::return_on_miss<return_type<Visitor>, R>{std::forward<R>(default_ret)});
+    }
+
+    // Returns fallback(value) when the value is in no interval.
+    template <typename Visitor, typename U, typename F>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor> visit_or(Visitor &&visitor, U &&value,
+                                                                       F &&fallback) {
+        return dispatch<return_type<Visitor>>(
+            std::forward<Visitor>(visitor), std::forward<U>(value),
+            detail::call_on_miss<return_type<Visitor>, F>{std::forward<F>(fallback)});
+    }
+
+    // The index of the interval of the value, or size if it is in none.
+    static INTEGRAL_SWITCH_ALWAYS_INLINE std::size_t index_of(T value) {
+        const std::size_t index = count(value) - 1;
+
+        return index < size ? index : size;
+    }
+};
+
+template <typename T, T... bounds> constexpr std::size_t range_switch<T, bounds...>::size;
+
+} // namespace integral_switch
+
+#endif
@@ -0,0 +1,282 @@
+/*
+ * rcu_switch.h
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef RCU_SWITCH_H_
+#define RCU_SWITCH_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "dynamic_switch.h"
+
+// Maximum number of readers of an rcu_switch alive at the same time.
+#ifndef INTEGRAL_SWITCH_MAX_READERS
+#define INTEGRAL_SWITCH_MAX_READERS 64
+#endif
+
+namespace integral_switch {
+
+namespace detail {
+
+// A handler of an rcu_switch. Nodes are immutable once published and destroyed through destroy.
+template <typename Signature> struct handler_node; // undefined
+
+template <typename R, typename... Args> struct handler_node<R(Args...)> {
+    R (*invoke)(const handler_node *, Args &&...);
+    void (*destroy)(const handler_node *);
+};
+
+template <typename Signature, typename F> struct handler_node_of; // undefined
+
+template <typename R, typename... Args, typename F>
+struct handler_node_of<R(Args...), F> : handler_node<R(Args...)> {
+    using base = handler_node<R(Args...)>;
+
+    F handler;
+
+    static R invoke_handler(const base *node, Args &&... args) {
+        return static_cast<const handler_node_of *>(node)->handler(std::forward<Args>(args)...);
+    }
+
+    static void destroy_handler(const base *node) {
+        delete static_cast<const handler_node_of *>(node);
+    }
+
+    template <typename G>
+    explicit handler_node_of(G &&h)
+        : base{&invoke_handler, &destroy_handler}, handler(std::forward<G>(h)) {}
+};
+
+// The epoch a reader entered its read-side critical section in, or 0 outside of one.
+struct alignas(INTEGRAL_SWITCH_CACHE_LINE_SIZE) reader_slot {
+    std::atomic<std::uint64_t> epoch{0};
+    std::atomic<bool> claimed{false};
+};
+
+} // namespace detail
+
+// A dynamic_switch whose handlers can be replaced while other threads visit it. Readers never
+// lock: each reader thread owns a reader, which publishes the epoch it reads in. A replaced handler
+// is retired with the epoch of its replacement and destroyed once no reader can still see it.
+// Writers are serialised by a mutex and heap allocate the new handler.
+template <typename Signature, typename T, T... v> class rcu_switch; // undefined
+
+template <typename R, typename... Args, typename T, T... v> class rcu_switch<R(Args...), T, v...> {
+    using index = detail::key_index<T, v...>;
+    using node = detail::handler_node<R(Args...)>;
+    using policy = typename miss_policy<rcu_switch>::type;
+
+    static constexpr std::size_t size = sizeof...(v);
+
+    struct retired_node {
+        const node *handler;
+        std::uint64_t epoch;
+    };
+
+    // The slot after the last key stays empty and catches the values that are not keys.
+    alignas(INTEGRAL_SWITCH_CACHE_LINE_SIZE) std::atomic<const node *> handlers_[size + 1];
+    detail::reader_slot readers_[INTEGRAL_SWITCH_MAX_READERS];
+    alignas(INTEGRAL_SWITCH_CACHE_LINE_SIZE) std::atomic<std::uint64_t> epoch_{1};
+
+    std::mutex writer_mutex_;
+    std::vector<retired_node> retired_;
+
+    void replace(std::size_t i, const node *handler) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+
+        const node *old = handlers_[i].exchange(handler);
+
+        if (old != nullptr) {
+            retired_.push_back(retired_node{old, epoch_.fetch_add(1) + 1});
+        }
+        collect();
+    }
+
+    // Destroys the retired handlers that every reader has moved past. Requires writer_mutex_.
+    std::size_t collect() {
+        std::uint64_t oldest = epoch_.load();
+
+        for (const auto &reader : readers_) {
+            const std::uint64_t e = reader.epoch.load();
+
+            if (e != 0 && e < oldest) {
+                oldest = e;
+            }
+        }
+
+        std::size_t kept = 0;
+
+        for (const auto &r : retired_) {
+            if (r.epoch <= oldest) {
+                r.handler->destroy(r.handler);
+            } else {
+                retired_[kept++] = r;
+            }
+        }
+        retired_.resize(kept);
+        return kept;
+    }
+
+    template <typename F> static const node *make_node(F &&handler) {
+        return new detail::handler_node_of<R(Args...), typename std::decay<F>::type>(
+            std::forward<F>(handler));
+    }
+
+  public:
+    // A reader is used by one thread at a time. visit() enters and leaves a read-side critical
+    // section around every call; a read_guard keeps one open across several calls.
+    class reader {
+        rcu_switch *switch_;
+        detail::reader_slot *slot_;
+        std::size_t depth_ = 0;
+
+        friend class rcu_switch;
+
+        reader(rcu_switch *s, detail::reader_slot *slot) : switch_(s), slot_(slot) {}
+
+      public:
+        reader(reader &&other) noexcept
+            : switch_(other.switch_), slot_(other.slot_), depth_(other.depth_) {
+            other.slot_ = nullptr;
+        }
+
+        reader(const reader &) = delete;
+        reader &operator=(const reader &) = delete;
+        reader &operator=(reader &&) = delete;
+
+        ~reader() {
+            if (slot_ != nullptr) {
+                slot_->epoch.store(0);
+                slot_->claimed.store(false, std::memory_order_release);
+            }
+        }
+
+        INTEGRAL_SWITCH_ALWAYS_INLINE void lock() {
+            if (depth_++ == 0) {
+                slot_->epoch.store(switch_->epoch_.load(std::memory_order_acquire));
+            }
+        }
+
+        INTEGRAL_SWITCH_ALWAYS_INLINE void unlock() {
+            if (--depth_ == 0) {
+                slot_->epoch.store(0, std::memory_order_release);
+            }
+        }
+
+        // Calls the handler bound to the key, or the miss policy if there is none.
+        INTEGRAL_SWITCH_ALWAYS_INLINE R visit(T key, Args... args) {
+            std::lock_guard<reader> guard(*this);
+
+            const node *handler = switch_->handlers_[index::of(key)].load();
+
+            return handler != nullptr ? handler->invoke(handler, std::forward<Args>(args)...)
+                                      : policy::template miss<R>(key);
+        }
+    };
+
+    using read_guard = std::lock_guard<reader>;
+
+    rcu_switch() {
+        for (auto &handler : handlers_) {
+            handler.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    rcu_switch(const rcu_switch &) = delete;
+    rcu_switch &operator=(const rcu_switch &) = delete;
+
+    // Requires that no reader is alive.
+    ~rcu_switch() {
+        for (auto &handler : handlers_) {
+            const node *h = handler.load(std::memory_order_relaxed);
+
+            if (h != nullptr) {
+                h->destroy(h);
+            }
+        }
+
+        for (const auto &r : retired_) {
+            r.handler->destroy(r.handler);
+        }
+    }
+
+    // Claims one of the INTEGRAL_SWITCH_MAX_READERS reader slots. Throws std::length_error, or
+    // aborts when exceptions are disabled, if all of them are taken.
+    reader make_reader() {
+        for (auto &slot : readers_) {
+            bool expected = false;
+
+            if (!slot.claimed.load(std::memory_order_relaxed) &&
+                slot.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return reader(this, &slot);
+            }
+        }
+
+#ifdef USE_CPP_EXCEPTIONS
+        throw std::length_error("rcu_switch: too many readers");
+#else
+        std::abort();
+#endif
+    }
+
+    // Replaces the handler of a key. The previous handler is destroyed once no reader uses it.
+    template <T u, typename F> void bind(F &&handler) {
+        replace(detail::position_of<T, u>(typename index::positions{}),
+                make_node(std::forward<F>(handler)));
+    }
+
+    // Returns false if the key is not one of the keys of the switch.
+    template <typename F> bool bind(T key, F &&handler) {
+        const std::size_t i = index::of(key);
+
+        if (i == size) {
+            return false;
+        }
+
+        replace(i, make_node(std::forward<F>(handler)));
+        return true;
+    }
+
+    void unbind(T key) {
+        const std::size_t i = index::of(key);
+
+        if (i != size) {
+            replace(i, nullptr);
+        }
+    }
+
+    bool bound(T key) const { return handlers_[index::of(key)].load() != nullptr; }
+
+    // Destroys the retired handlers that no reader can see any more and returns the number of
+    // handlers still waiting for readers. Binding does this as well.
+    std::size_t reclaim() {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+
+        return collect();
+    }
+};
+
+} // namespace integral_switch
+
+#endif
@@ -0,0 +1,149 @@
+/*
+ * sharded_dispatcher.h
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SHARDED_DISPATCHER_H_
+#define SHARDED_DISPATCHER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "mpsc_queue.h"
+
+// Maximum number of messages a worker of a sharded_dispatcher handles per call to consume().
+#ifndef INTEGRAL_SWITCH_DISPATCH_BATCH
+#define INTEGRAL_SWITCH_DISPATCH_BATCH 64
+#endif
+
+namespace integral_switch {
+
+// Routes messages of the types Ts to Shards worker threads. Every worker owns a copy of the handler
+// and drains its own queue of Capacity bytes, dispatching on the type tag of every message, so
+// there is no state shared between the workers. post<U>() sends all messages of one type to the
+// same shard and post_keyed<U>(key) all messages with equal keys, which keeps them in order.
+template <std::size_t Shards, std::size_t Capacity, typename Handler, typename... Ts>
+class sharded_dispatcher {
+    static_assert(Shards > 0, "a dispatcher needs at least one shard");
+
+    using queue_type = mpsc_queue<Capacity, Ts...>;
+
+    queue_type queues_[Shards];
+    std::vector<Handler> handlers_;
+    std::thread workers_[Shards];
+    alignas(INTEGRAL_SWITCH_CACHE_LINE_SIZE) std::atomic<bool> stopping_{false};
+
+    void run(std::size_t shard) {
+        queue_type &queue = queues_[shard];
+        Handler &handler = handlers_[shard];
+
+        for (;;) {
+            const bool stopping = stopping_.load(std::memory_order_acquire);
+
+            if (queue.consume(handler, INTEGRAL_SWITCH_DISPATCH_BATCH) == 0) {
+                if (stopping) {
+                    return;
+                }
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Pins the worker of a shard to the core with the same number, modulo the number of cores.
+    void pin(std::size_t shard) {
+#if defined(__linux__)
+        const unsigned cores = std::thread::hardware_concurrency();
+        cpu_set_t set;
+
+        CPU_ZERO(&set);
+        CPU_SET(cores == 0 ? 0 : shard % cores, &set);
+        pthread_setaffinity_np(workers_[shard].native_handle(), sizeof(set), &set);
+#else
+        static_cast<void>(shard);
+#endif
+    }
+
+    template <typename U, typename... Args> void push(std::size_t shard, Args &&... args) {
+        while (!queues_[shard].template try_emplace<U>(std::forward<Args>(args)...)) {
+            std::this_thread::yield();
+        }
+    }
+
+  public:
+    // Starts the workers with copies of the handler. pin_to_cores has no effect outside of Linux.
+    explicit sharded_dispatcher(const Handler &handler = Handler(), bool pin_to_cores = false)
+        : handlers_(Shards, handler) {
+        for (std::size_t i = 0; i < Shards; ++i) {
+            workers_[i] = std::thread(&sharded_dispatcher::run, this, i);
+
+            if (pin_to_cores) {
+                pin(i);
+            }
+        }
+    }
+
+    sharded_dispatcher(const sharded_dispatcher &) = delete;
+    sharded_dispatcher &operator=(const sharded_dispatcher &) = delete;
+
+    ~sharded_dispatcher() { stop(); }
+
+    // The shard of all messages of type U sent with post().
+    template <typename U> static constexpr std::size_t shard_of() {
+        return detail::type_index<U, Ts...>::value % Shards;
+    }
+
+    // The shard of all messages sent with post_keyed() and this key.
+    template <typename Key> static std::size_t shard_of(const Key &key) {
+        return std::hash<Key>()(key) % Shards;
+    }
+
+    // Constructs a U in the queue of its shard, waiting while the queue is full.
+    template <typename U, typename... Args> void post(Args &&... args) {
+        push<U>(shard_of<U>(), std::forward<Args>(args)...);
+    }
+
+    template <typename U, typename Key, typename... Args>
+    void post_keyed(const Key &key, Args &&... args) {
+        push<U>(shard_of(key), std::forward<Args>(args)...);
+    }
+
+    // Waits until every message posted before is handled and stops the workers.
+    void stop() {
+        stopping_.store(true, std::memory_order_release);
+
+        for (auto &worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    // The handler of a shard. Must only be used after stop().
+    const Handler &handler(std::size_t shard) const { return handlers_[shard]; }
+};
+
+} // namespace integral_switch
+
+#endif
@@ -0,0 +1,476 @@
+/*
+ * string_switch.h
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef STRING_SWITCH_H_
+#define STRING_SWITCH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "integral_switch.h"
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+#define USE_CPP_20_STRING_TEMPLATE_ARGS
+#endif
+
+// Number of hash seeds that are tried before the keys of a string_switch are taken to be equal.
+#ifndef INTEGRAL_SWITCH_STRING_SEEDS
+#define INTEGRAL_SWITCH_STRING_SEEDS 256
+#endif
+
+namespace integral_switch {
+
+// A string as a type, e.g. string_key<'G', 'E', 'T'>. The cases of a string_switch are called with
+// the string_key of their key.
+template <char... cs> struct string_key {
+    static constexpr std::size_t size = sizeof...(cs);
+    static constexpr char data[sizeof...(cs) + 1] = {cs..., '\0'};
+};
+
+template <char... cs> constexpr std::size_t string_key<cs...>::size;
+template <char... cs> constexpr char string_key<cs...>::data[sizeof...(cs) + 1];
+
+namespace detail {
+
+// FNV-1a, with the seed mixed into the offset basis. string_hash() hashes the keys at compile
+// time and hash_bytes() the values at run time; both must give the same results.
+constexpr std::uint32_t string_hash(const char *s, std::size_t n, std::uint32_t h) {
+    return n == 0 ? h
+                  : string_hash(s + 1, n - 1,
+                                (h ^ static_cast<unsigned char>(*s)) * UINT32_C(16777619));
+}
+
+constexpr std::uint32_t string_hash_basis(std::uint32_t seed) {
+    return UINT32_C(2166136261) ^ (seed * UINT32_C(0x9e3779b9));
+}
+
+INTEGRAL_SWITCH_ALWAYS_INLINE std::uint32_t hash_bytes(const char *s, std::size_t n,
+                                                       std::uint32_t seed) {
+    std::uint32_t h = string_hash_basis(seed);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        h = (h ^ static_cast<unsigned char>(s[i])) * UINT32_C(16777619);
+    }
+    return h;
+}
+
+template <typename Key> constexpr std::uint32_t key_hash(std::uint32_t seed) {
+    return string_hash(Key::data, Key::size, string_hash_basis(seed));
+}
+
+// Like is_ascending(), these halve the ranges so that the recursion depth stays logarithmic.
+template <typename T>
+constexpr bool contains(const T *keys, std::size_t first, std::size_t count, T key) {
+    return count == 0   ? false
+           : count == 1 ? keys[first] == key
+                        : contains(keys, first, count / 2, key) ||
+                              contains(keys, first + count / 2, count - count / 2, key);
+}
+
+template <typename T>
+constexpr bool disjoint(const T *keys, std::size_t first, std::size_t count,
+                        std::size_t other_first, std::size_t other_count) {
+    return count == 0 ? true
+           : count == 1
+               ? !contains(keys, other_first, other_count, keys[first])
+               : disjoint(keys, first, count / 2, other_first, other_count) &&
+                     disjoint(keys, first + count / 2, count - count / 2, other_first,
+                              other_count);
+}
+
+template <typename T>
+constexpr bool all_distinct(const T *keys, std::size_t first, std::size_t count) {
+    return count < 2 ? true
+                     : all_distinct(keys, first, count / 2) &&
+                           all_distinct(keys, first + count / 2, count - count / 2) &&
+                           disjoint(keys, first, count / 2, first + count / 2,
+                                    count - count / 2);
+}
+
+template <std::uint32_t Seed, typename... Keys> struct distinct_hashes {
+    static constexpr bool value =
+        all_distinct(key_array<std::uint32_t, key_hash<Keys>(Seed)...>::values, 0,
+                     sizeof...(Keys));
+};
+
+// The first seed for which the hashes of all keys differ. Keys that are equal collide for
+// every seed, so the search gives up after INTEGRAL_SWITCH_STRING_SEEDS seeds.
+template <std::uint32_t Seed, bool Found, typename... Keys>
+struct find_string_seed
+    : find_string_seed<Seed + 1,
+                       Seed + 1 == INTEGRAL_SWITCH_STRING_SEEDS ||
+                           distinct_hashes<Seed + 1, Keys...>::value,
+                       Keys...> {};
+
+template <std::uint32_t Seed, typename... Keys>
+struct find_string_seed<Seed, true, Keys...> {
+    static constexpr std::uint32_t value = Seed;
+};
+
+#ifdef USE_CPP_14_CONSTEXPR
+constexpr std::size_t ceil_power_of_two(std::size_t n) {
+    std::size_t p = 1;
+
+    while (p < n) {
+        p *= 2;
+    }
+    return p;
+}
+
+// The slot of the hash h among the 2^bits slots of its bucket under the seed of the bucket. The
+// high bits of the product depend on all bits of h, not only on those that select the bucket.
+constexpr std::uint32_t bucket_slot(std::uint32_t h, std::uint32_t seed, std::uint32_t bits) {
+    return bits == 0 ? 0
+                     : static_cast<std::uint32_t>((h ^ (seed * UINT32_C(0x9e3779b9))) *
+                                                  UINT32_C(0x85ebca6b)) >>
+                           (32 - bits);
+}
+
+constexpr bool distinct_slots(const std::uint32_t *hashes, std::size_t n, std::uint32_t seed,
+                              std::uint32_t bits) {
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = i + 1; j < n; ++j) {
+            if (bucket_slot(hashes[i], seed, bits) == bucket_slot(hashes[j], seed, bits)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// The buckets of a perfect hash of Size distinct hashes. The entry of a bucket holds its first
+// slot in the upper half, and its seed and the number of bits of its slots in the lower half.
+template <std::size_t Size> struct hash_buckets {
+    static constexpr std::size_t count = ceil_power_of_two(Size);
+
+    std::uint64_t entries[count];
+    std::size_t slots;
+    bool found;
+};
+
+// The low bits of a hash select one of the buckets, and the n hashes of a bucket get the first
+// seed under which they map to distinct slots among the next power of two from n * n, which takes
+// two attempts on average.
+template <std::size_t Size>
+constexpr hash_buckets<Size> place_buckets(const std::uint32_t *key_hashes) {
+    constexpr std::size_t count = hash_buckets<Size>::count;
+    constexpr std::uint32_t mask = static_cast<std::uint32_t>(count - 1);
+
+    hash_buckets<Size> buckets{{}, 0, true};
+    std::uint32_t hashes[Size] = {};
+    std::uint32_t members[Size] = {};
+    std::size_t starts[count + 1] = {};
+    std::size_t next[count] = {};
+
+    for (std::size_t i = 0; i < Size; ++i) {
+        hashes[i] = key_hashes[i];
+        ++starts[(hashes[i] & mask) + 1];
+    }
+
+    for (std::size_t b = 0; b < count; ++b) {
+        starts[b + 1] += starts[b];
+        next[b] = starts[b];
+    }
+
+    for (std::size_t i = 0; i < Size; ++i) {
+        members[next[hashes[i] & mask]++] = hashes[i];
+    }
+
+    for (std::size_t b = 0; b < count; ++b) {
+        const std::size_t n = starts[b + 1] - starts[b];
+
+        if (n == 0) {
+            continue;
+        }
+
+        std::uint32_t bits = 0;
+        std::uint32_t seed = 0;
+
+        while ((std::size_t(1) << bits) < n * n) {
+            ++bits;
+        }
+
+        while (seed < INTEGRAL_SWITCH_STRING_SEEDS &&
+               !distinct_slots(members + starts[b], n, seed, bits)) {
+            ++seed;
+        }
+
+        buckets.found = buckets.found && seed < INTEGRAL_SWITCH_STRING_SEEDS;
+        buckets.entries[b] = std::uint64_t(buckets.slots) << 32 | std::uint64_t(seed) << 8 | bits;
+        buckets.slots += std::size_t(1) << bits;
+    }
+
+    // Empty buckets point past the slots of the others, where no position is stored.
+    for (std::size_t b = 0; b < count; ++b) {
+        if (starts[b + 1] == starts[b]) {
+            buckets.entries[b] = std::uint64_t(buckets.slots) << 32;
+        }
+    }
+    return buckets;
+}
+
+// The position of the key in every slot, and the number of keys in empty slots.
+template <std::size_t Slots> struct hash_slots {
+    std::uint32_t positions[Slots + 1];
+};
+
+INTEGRAL_SWITCH_ALWAYS_INLINE constexpr std::size_t slot_of(std::uint64_t entry, std::uint32_t h) {
+    return static_cast<std::size_t>(entry >> 32) +
+           bucket_slot(h, static_cast<std::uint32_t>(entry) >> 8, entry & 0xff);
+}
+
+// The buckets are taken by value, since reading the elements of a static array in a constant
+// expression takes time proportional to its size with GCC.
+template <std::size_t Size, std::size_t Slots>
+constexpr hash_slots<Slots> place_slots(const std::uint32_t *hashes, hash_buckets<Size> buckets) {
+    constexpr std::uint32_t mask = static_cast<std::uint32_t>(hash_buckets<Size>::count - 1);
+
+    hash_slots<Slots> slots{};
+
+    for (std::size_t s = 0; s <= Slots; ++s) {
+        slots.positions[s] = static_cast<std::uint32_t>(Size);
+    }
+
+    for (std::size_t i = 0; i < Size; ++i) {
+        const std::uint32_t h = hashes[i];
+
+        slots.positions[slot_of(buckets.entries[h & mask], h)] = static_cast<std::uint32_t>(i);
+    }
+    return slots;
+}
+
+// Maps a hash to the position of the only one of the distinct hashes hs that it can equal, or to
+// their number. From C++14 on this is a perfect hash in two levels, built at compile time, that
+// takes two loads.
+template <std::uint32_t... hs> struct hash_index {
+    using hashes = key_array<std::uint32_t, hs...>;
+
+    static constexpr std::size_t size = sizeof...(hs);
+    static constexpr std::uint32_t mask = static_cast<std::uint32_t>(hash_buckets<size>::count - 1);
+
+    using bucket_table = hash_buckets<size>;
+
+    static constexpr bucket_table buckets = place_buckets<size>(hashes::values);
+
+    static_assert(buckets.found, "no seed separates the keys of a bucket of a string_switch; "
+                                 "raise INTEGRAL_SWITCH_STRING_SEEDS");
+
+    using slot_table = hash_slots<buckets.slots>;
+
+    static constexpr slot_table slots = place_slots<size, buckets.slots>(hashes::values, buckets);
+
+    static INTEGRAL_SWITCH_ALWAYS_INLINE std::size_t position(std::uint32_t h) {
+        return slots.positions[slot_of(buckets.entries[h & mask], h)];
+    }
+};
+
+template <std::uint32_t... hs>
+constexpr typename hash_index<hs...>::bucket_table hash_index<hs...>::buckets;
+template <std::uint32_t... hs>
+constexpr typename hash_index<hs...>::slot_table hash_index<hs...>::slots;
+#else
+// Before C++14 the hash is mapped to the position of its key with an integral_switch over the
+// hashes of the keys.
+template <typename Positions> struct hash_position_visitor {
+    template <std::uint32_t h>
+    INTEGRAL_SWITCH_ALWAYS_INLINE std::size_t
+    operator()(std::integral_constant<std::uint32_t, h>) const {
+        return position_of<std::uint32_t, h>(Positions{});
+    }
+};
+
+template <std::uint32_t... hs> struct hash_index {
+    using hash_switch = integral_switch<std::uint32_t, hs...>;
+    using positions = key_positions<std::uint32_t, make_index_sequence<sizeof...(hs)>, hs...>;
+
+    static INTEGRAL_SWITCH_ALWAYS_INLINE std::size_t position(std::uint32_t h) {
+        return hash_switch::visit_nothrow(hash_position_visitor<positions>{}, h, sizeof...(hs));
+    }
+};
+#endif
+
+template <typename Key>
+INTEGRAL_SWITCH_ALWAYS_INLINE bool equals_key(const char *data, std::size_t size) {
+    return size == Key::size && (Key::size == 0 || std::memcmp(data, Key::data, Key::size) == 0);
+}
+
+// Calls the case of the key at position i once the value compares equal to the key.
+template <typename Ret, typename Visitor, typename U, typename Miss, typename... Keys>
+struct string_case_visitor {
+    Visitor &&visitor;
+    U &&value;
+    Miss &&miss;
+    const char *data;
+    std::size_t size;
+
+    template <std::size_t i>
+    INTEGRAL_SWITCH_ALWAYS_INLINE Ret operator()(std::integral_constant<std::size_t, i>) const {
+        using key = type_at<i, Keys...>;
+
+        if (equals_key<key>(data, size)) {
+            return visitor(key{});
+        }
+        return miss(std::forward<U>(value));
+    }
+};
+
+template <typename... Keys> struct string_position_visitor {
+    const char *data;
+    std::size_t size;
+
+    template <std::size_t i>
+    INTEGRAL_SWITCH_ALWAYS_INLINE std::size_t
+    operator()(std::integral_constant<std::size_t, i>) const {
+        return equals_key<type_at<i, Keys...>>(data, size) ? i : sizeof...(Keys);
+    }
+};
+
+template <typename Ret, typename U, typename Miss> struct string_miss {
+    U &&value;
+    Miss &&miss;
+
+    Ret operator()(std::size_t) const { return miss(std::forward<U>(value)); }
+};
+
+} // namespace detail
+
+// Dispatches on strings. The value is hashed with a hash whose seed is chosen at compile time so
+// that no two keys collide, a perfect hash maps the hash to the position of the only key it can
+// be, the position is dispatched with a dense integral_switch and the case it selects compares
+// the value to its key with a single memcmp. Values are anything with data() and size(), e.g.
+// std::string or std::string_view.
+template <typename... Keys> class basic_string_switch {
+    static_assert(sizeof...(Keys) > 0, "a string_switch needs at least one key");
+
+    static constexpr std::uint32_t seed = detail::find_string_seed<
+        0, detail::distinct_hashes<0, Keys...>::value, Keys...>::value;
+
+    static_assert(detail::distinct_hashes<seed, Keys...>::value,
+                  "the keys of a string_switch must be distinct");
+
+    using hash_index = detail::hash_index<detail::key_hash<Keys>(seed)...>;
+
+    using position_switch = make_integral_switch<detail::index_sequence_for<Keys...>>;
+
+    template <typename Visitor, typename Key>
+    using return_type_of = decltype(std::declval<Visitor>()(Key{}));
+
+    template <typename Ret, typename Visitor, typename U, typename Miss>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE Ret dispatch(Visitor &&visitor, U &&value, Miss &&miss) {
+        static_assert(
+            detail::all<std::is_same<Ret, return_type_of<Visitor, Keys>>::value...>::value,
+            "All return types must be equal");
+
+        const char *data = value.data();
+        const std::size_t size = value.size();
+
+        detail::string_case_visitor<Ret, Visitor, U, Miss, Keys...> cases{
+            std::forward<Visitor>(visitor), std::forward<U>(value), std::forward<Miss>(miss), data,
+            size};
+        detail::string_miss<Ret, U, Miss> fallback{std::forward<U>(value),
+                                                   std::forward<Miss>(miss)};
+
+        return position_switch::visit_or(
+            cases, hash_index::position(detail::hash_bytes(data, size, seed)), fallback);
+    }
+
+  public:
+    template <typename Visitor>
+    using return_type = return_type_of<Visitor, detail::first_t<Keys...>>;
+
+    template <typename Policy = typename miss_policy<basic_string_switch>::type, typename Visitor,
+              typename U>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor> visit(Visitor &&visitor, U &&value) {
+        return dispatch<return_type<Visitor>>(
+            std::forward<Visitor>(visitor), std::forward<U>(value),
+            detail::policy_on_miss<return_type<Visitor>, Policy>{});
+    }
+
+    // Sets ec instead of applying the miss policy when the value is not a key, and then returns
+    // a value initialised result.
+    template <typename Visitor, typename U>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor> visit(Visitor &&visitor, U &&value,
+                                                                    std::error_code &ec) {
+        ec.clear();
+        return dispatch<return_type<Visitor>>(std::forward<Visitor>(visitor),
+                                              std::forward<U>(value),
+                                              detail::error_on_miss<return_type<Visitor>>{ec});
+    }
+
+    template <typename Visitor, typename U, typename R>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor>
+    visit_nothrow(Visitor &&visitor, U &&value, R &&default_ret) {
+        return dispatch<return_type<Visitor>>(
+            std::forward<Visitor>(visitor), std::forward<U>(value),
+            detail::return_on_miss<return_type<Visitor>, R>{std::forward<R>(default_ret)});
+    }
+
+    // Returns fallback(value) when the value is not a key.
+    template <typename Visitor, typename U, typename F>
+    static INTEGRAL_SWITCH_ALWAYS_INLINE return_type<Visitor> visit_or(Visitor &&visitor, U &&value,
+                                                                       F &&fallback) {
+        return dispatch<return_type<Visitor>>(
+            std::forward<Visitor>(visitor), std::forward<U>(value),
+            detail::call_on_miss<return_type<Visitor>, F>{std::forward<F>(fallback)});
+    }
+
+    // The position of the key that equals the value, or the number of keys if there is none.
+    template <typename U> static INTEGRAL_SWITCH_ALWAYS_INLINE std::size_t find(const U &value) {
+        const char *data = value.data();
+        const std::size_t size = value.size();
+
+        return position_switch::visit_nothrow(
+            detail::string_position_visitor<Keys...>{data, size},
+            hash_index::position(detail::hash_bytes(data, size, seed)), sizeof...(Keys));
+    }
+};
+
+#ifdef USE_CPP_20_STRING_TEMPLATE_ARGS
+// A string literal as a template argument, e.g. string_switch<"GET", "PUT">.
+template <std::size_t N> struct fixed_string {
+    char data[N];
+
+    constexpr fixed_string(const char (&s)[N]) {
+        for (std::size_t i = 0; i < N; ++i) {
+            data[i] = s[i];
+        }
+    }
+};
+
+namespace detail {
+
+template <fixed_string S, typename Seq = make_index_sequence<sizeof(S.data) - 1>>
+struct string_key_of; // undefined
+
+template <fixed_string S, std::size_t... Is> struct string_key_of<S, index_sequence<Is...>> {
+    using type = string_key<S.data[Is]...>;
+};
+
+} // namespace detail
+
+template <fixed_string... S>
+using string_switch = basic_string_switch<typename detail::string_key_of<S>::type...>;
+#endif
+
+} // namespace integral_switch
+
+#endif
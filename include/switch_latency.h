@@ -0,0 +1,247 @@
+/*
+ * switch_latency.h
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SWITCH_LATENCY_H_
+#define SWITCH_LATENCY_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "integral_switch.h"
+
+// By default every visit_timed() call in this many on a thread is timed.
+#ifndef INTEGRAL_SWITCH_LATENCY_SAMPLE
+#define INTEGRAL_SWITCH_LATENCY_SAMPLE 1024
+#endif
+
+namespace integral_switch {
+
+namespace detail {
+
+// Log-linear buckets: durations below 16ns have a bucket each, and every power of two above is
+// split into 16 buckets, which bounds the relative error by 1/16. Durations of 2^36ns (about a
+// minute) and more share the last bucket.
+constexpr std::size_t latency_sub_buckets = 16;
+constexpr std::size_t latency_max_exponent = 36;
+constexpr std::size_t latency_buckets = (latency_max_exponent - 3) * latency_sub_buckets;
+
+inline std::size_t floor_log2(std::uint64_t x) {
+#if defined(__GNUC__)
+    return 63 - static_cast<std::size_t>(__builtin_clzll(x));
+#else
+    std::size_t e = 0;
+
+    while (x >>= 1) {
+        ++e;
+    }
+    return e;
+#endif
+}
+
+inline std::size_t latency_bucket(std::uint64_t ns) {
+    if (ns < latency_sub_buckets) {
+        return static_cast<std::size_t>(ns);
+    }
+
+    const std::size_t e = floor_log2(ns);
+
+    if (e >= latency_max_exponent) {
+        return latency_buckets - 1;
+    }
+    return (e - 3) * latency_sub_buckets + ((ns >> (e - 4)) & (latency_sub_buckets - 1));
+}
+
+// The largest duration that falls into a bucket.
+inline std::uint64_t latency_bucket_max(std::size_t bucket) {
+    if (bucket < latency_sub_buckets) {
+        return bucket;
+    }
+
+    const std::size_t e = bucket / latency_sub_buckets + 3;
+    const std::uint64_t m = bucket % latency_sub_buckets;
+
+    return ((latency_sub_buckets + m + 1) << (e - 4)) - 1;
+}
+
+} // namespace detail
+
+template <typename T> struct latency_summary {
+    T key;
+    std::uint64_t samples;
+    // Upper bounds of the percentiles in nanoseconds.
+    std::uint64_t p50;
+    std::uint64_t p99;
+    std::uint64_t p999;
+};
+
+template <typename Switch> class switch_latency; // undefined
+
+// Sampled latency histograms of the cases of an integral_switch. visit_timed<Switch>() times every
+// Nth call on a thread with std::chrono::steady_clock and adds the duration of the visitor to a
+// histogram of the key. The other calls cost one decrement of a thread local counter. Histograms
+// are shared between threads, which only contend on the sampled calls.
+template <typename T, T... v> class switch_latency<integral_switch<T, v...>> {
+    static constexpr std::size_t size = sizeof...(v);
+
+    using positions = detail::key_positions<T, detail::make_index_sequence<size>, v...>;
+
+    struct alignas(INTEGRAL_SWITCH_CACHE_LINE_SIZE) histogram {
+        std::atomic<std::uint64_t> buckets[detail::latency_buckets];
+    };
+
+    static histogram histograms_[size];
+    static thread_local std::uint32_t interval_;
+    static thread_local std::uint32_t countdown_;
+
+    static std::uint64_t percentile(const std::uint64_t *buckets, std::uint64_t samples, double p) {
+        const auto rank = static_cast<std::uint64_t>(p * static_cast<double>(samples));
+        std::uint64_t seen = 0;
+
+        for (std::size_t i = 0; i < detail::latency_buckets; ++i) {
+            seen += buckets[i];
+
+            if (seen > rank) {
+                return detail::latency_bucket_max(i);
+            }
+        }
+        return 0;
+    }
+
+  public:
+    // Records the duration of the visitor between its construction and destruction.
+    template <T u> class timer {
+        std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+
+      public:
+        ~timer() {
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - start_)
+                                .count();
+
+            record<u>(static_cast<std::uint64_t>(ns < 0 ? 0 : ns));
+        }
+    };
+
+    template <T u> static void record(std::uint64_t ns) {
+        histograms_[detail::position_of<T, u>(positions{})]
+            .buckets[detail::latency_bucket(ns)]
+            .fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Times one in every interval calls of visit_timed() on the calling thread.
+    static void set_sample_interval(std::uint32_t interval) {
+        interval_ = interval == 0 ? 1 : interval;
+        countdown_ = interval_;
+    }
+
+    // Whether the next call on this thread is to be timed.
+    static INTEGRAL_SWITCH_ALWAYS_INLINE bool sample() {
+        if (--countdown_ != 0) {
+            return false;
+        }
+        countdown_ = interval_;
+        return true;
+    }
+
+    // The number of samples and p50, p99 and p999 of every key, in the order of the keys.
+    static std::vector<latency_summary<T>> summary() {
+        const T keys[] = {v...};
+        std::vector<latency_summary<T>> result;
+        std::vector<std::uint64_t> buckets(detail::latency_buckets);
+
+        for (std::size_t k = 0; k < size; ++k) {
+            std::uint64_t samples = 0;
+
+            for (std::size_t i = 0; i < detail::latency_buckets; ++i) {
+                buckets[i] = histograms_[k].buckets[i].load(std::memory_order_relaxed);
+                samples += buckets[i];
+            }
+
+            result.push_back(latency_summary<T>{keys[k], samples,
+                                                percentile(buckets.data(), samples, 0.5),
+                                                percentile(buckets.data(), samples, 0.99),
+                                                percentile(buckets.data(), samples, 0.999)});
+        }
+        return result;
+    }
+
+    static void reset() {
+        for (auto &h : histograms_) {
+            for (auto &bucket : h.buckets) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+template <typename T, T... v>
+typename switch_latency<integral_switch<T, v...>>::histogram
+    switch_latency<integral_switch<T, v...>>::histograms_[switch_latency::size];
+
+template <typename T, T... v>
+thread_local std::uint32_t switch_latency<integral_switch<T, v...>>::interval_ =
+    INTEGRAL_SWITCH_LATENCY_SAMPLE;
+
+template <typename T, T... v>
+thread_local std::uint32_t switch_latency<integral_switch<T, v...>>::countdown_ =
+    INTEGRAL_SWITCH_LATENCY_SAMPLE;
+
+namespace detail {
+
+template <typename Switch, typename Visitor> struct timing_visitor {
+    Visitor &&visitor;
+
+    template <typename U, U u, typename Ret = decltype(std::declval<Visitor &>()(
+                                   std::integral_constant<U, u>{}))>
+    INTEGRAL_SWITCH_ALWAYS_INLINE Ret operator()(std::integral_constant<U, u> key) const {
+        typename switch_latency<Switch>::template timer<u> timer;
+
+        return visitor(key);
+    }
+};
+
+template <typename Switch, typename Policy, typename Visitor, typename U>
+INTEGRAL_SWITCH_NOINLINE typename Switch::template return_type<Visitor>
+visit_sampled(Visitor &&visitor, U &&value) {
+    timing_visitor<Switch, Visitor> timing{std::forward<Visitor>(visitor)};
+
+    return Switch::template visit<Policy>(std::move(timing), std::forward<U>(value));
+}
+
+} // namespace detail
+
+// Switch::visit() that adds the duration of every sampled call to switch_latency<Switch>. The
+// sampled calls go through a separate function, so that the others stay as cheap as visit().
+template <typename Switch, typename Policy = typename miss_policy<Switch>::type, typename Visitor,
+          typename U>
+INTEGRAL_SWITCH_ALWAYS_INLINE typename Switch::template return_type<Visitor>
+visit_timed(Visitor &&visitor, U &&value) {
+    if (switch_latency<Switch>::sample()) {
+        return detail::visit_sampled<Switch, Policy>(std::forward<Visitor>(visitor),
+                                                     std::forward<U>(value));
+    }
+    return Switch::template visit<Policy>(std::forward<Visitor>(visitor), std::forward<U>(value));
+}
+
+} // namespace integral_switch
+
+#endif
@@ -0,0 +1,200 @@
+/*
+ * switch_stats.h
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SWITCH_STATS_H_
+#define SWITCH_STATS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "integral_switch.h"
+
+// Number of threads that count into counters of their own. Further threads share one set of
+// counters, which they update with atomic read-modify-write operations.
+#ifndef INTEGRAL_SWITCH_STATS_THREADS
+#define INTEGRAL_SWITCH_STATS_THREADS 64
+#endif
+
+namespace integral_switch {
+
+template <typename Switch> class switch_stats; // undefined
+
+// Counts the hits of every key of an integral_switch and its misses. Every thread counts into a
+// cache line aligned block of relaxed counters of its own, so counting does not contend; a block
+// is handed to the next thread when its thread exits and snapshot() sums all blocks. Counting is
+// opt-in per call: visit through count_hits<Switch>(visitor) with the count_on_miss<Switch> policy,
+// or use visit_counted<Switch>(visitor, value), which does both.
+template <typename T, T... v> class switch_stats<integral_switch<T, v...>> {
+    static constexpr std::size_t size = sizeof...(v);
+
+    using positions = detail::key_positions<T, detail::make_index_sequence<size>, v...>;
+
+    struct alignas(INTEGRAL_SWITCH_CACHE_LINE_SIZE) block {
+        // The count after the last key counts the misses.
+        std::atomic<std::uint64_t> counts[size + 1];
+        std::atomic<bool> claimed;
+    };
+
+    // The block after the last one is shared by the threads that found no free block.
+    static block blocks_[INTEGRAL_SWITCH_STATS_THREADS + 1];
+
+    // The block of this thread, claimed on its first count. Both are constant initialised, so that
+    // counting needs no check whether a thread local object has been constructed.
+    static thread_local block *local_;
+    static thread_local bool owned_;
+
+    // Hands the block of a thread back when the thread exits. Counts from destructors of other
+    // thread local objects that run later go to the shared block, not to the next owner's block.
+    struct block_owner {
+        ~block_owner() {
+            if (owned_) {
+                local_->claimed.store(false, std::memory_order_release);
+                local_ = &blocks_[INTEGRAL_SWITCH_STATS_THREADS];
+                owned_ = false;
+            }
+        }
+    };
+
+    static INTEGRAL_SWITCH_NOINLINE block *claim() {
+        static thread_local block_owner owner;
+
+        local_ = &blocks_[INTEGRAL_SWITCH_STATS_THREADS];
+
+        for (std::size_t i = 0; i < INTEGRAL_SWITCH_STATS_THREADS; ++i) {
+            bool expected = false;
+
+            if (blocks_[i].claimed.compare_exchange_strong(expected, true,
+                                                           std::memory_order_acquire)) {
+                local_ = &blocks_[i];
+                owned_ = true;
+                break;
+            }
+        }
+
+        static_cast<void>(owner);
+        return local_;
+    }
+
+    static INTEGRAL_SWITCH_ALWAYS_INLINE void increment(std::size_t i) {
+        block *b = local_ != nullptr ? local_ : claim();
+        std::atomic<std::uint64_t> &count = b->counts[i];
+
+        if (owned_) {
+            count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        } else {
+            count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    static std::uint64_t total(std::size_t i) {
+        std::uint64_t sum = 0;
+
+        for (const auto &b : blocks_) {
+            sum += b.counts[i].load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+  public:
+    template <T u> static INTEGRAL_SWITCH_ALWAYS_INLINE void hit() {
+        increment(detail::position_of<T, u>(positions{}));
+    }
+
+    static void miss() { increment(size); }
+
+    // The number of hits of every key, in the order of the keys.
+    static std::vector<std::pair<T, std::uint64_t>> snapshot() {
+        const T keys[] = {v...};
+        std::vector<std::pair<T, std::uint64_t>> counts;
+
+        counts.reserve(size);
+
+        for (std::size_t i = 0; i < size; ++i) {
+            counts.emplace_back(keys[i], total(i));
+        }
+        return counts;
+    }
+
+    static std::uint64_t misses() { return total(size); }
+
+    // Sets all counters to zero. Counts of concurrent visits may be lost.
+    static void reset() {
+        for (auto &b : blocks_) {
+            for (auto &count : b.counts) {
+                count.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+template <typename T, T... v>
+typename switch_stats<integral_switch<T, v...>>::block
+    switch_stats<integral_switch<T, v...>>::blocks_[INTEGRAL_SWITCH_STATS_THREADS + 1];
+
+template <typename T, T... v>
+thread_local typename switch_stats<integral_switch<T, v...>>::block
+    *switch_stats<integral_switch<T, v...>>::local_ = nullptr;
+
+template <typename T, T... v>
+thread_local bool switch_stats<integral_switch<T, v...>>::owned_ = false;
+
+namespace detail {
+
+template <typename Switch, typename Visitor> struct counting_visitor {
+    Visitor &&visitor;
+
+    template <typename U, U u, typename Ret = decltype(std::declval<Visitor &>()(
+                                   std::integral_constant<U, u>{}))>
+    INTEGRAL_SWITCH_ALWAYS_INLINE Ret operator()(std::integral_constant<U, u> key) const {
+        switch_stats<Switch>::template hit<u>();
+        return visitor(key);
+    }
+};
+
+} // namespace detail
+
+// Counts every value that is not a key as a miss of the switch, then leaves it to Policy.
+template <typename Switch, typename Policy = typename miss_policy<Switch>::type>
+struct count_on_miss {
+    template <typename Ret, typename U> static Ret miss(U &&value) {
+        switch_stats<Switch>::miss();
+        return Policy::template miss<Ret>(std::forward<U>(value));
+    }
+};
+
+// Wraps a visitor so that every case it is called for counts as a hit of that key of Switch.
+template <typename Switch, typename Visitor>
+detail::counting_visitor<Switch, Visitor> count_hits(Visitor &&visitor) {
+    return {std::forward<Visitor>(visitor)};
+}
+
+// Switch::visit() that counts the hits and misses in switch_stats<Switch>.
+template <typename Switch, typename Policy = typename miss_policy<Switch>::type, typename Visitor,
+          typename U>
+INTEGRAL_SWITCH_ALWAYS_INLINE typename Switch::template return_type<Visitor>
+visit_counted(Visitor &&visitor, U &&value) {
+    return Switch::template visit<count_on_miss<Switch, Policy>>(
+        count_hits<Switch>(std::forward<Visitor>(visitor)), std::forward<U>(value));
+}
+
+} // namespace integral_switch
+
+#endif
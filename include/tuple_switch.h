@@ -0,0 +1,92 @@
+/*
+ * tuple_switch.h
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TUPLE_SWITCH_H_
+#define TUPLE_SWITCH_H_
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "integral_switch.h"
+
+namespace integral_switch {
+
+namespace detail {
+
+// Calls the visitor with the I-th element of the tuple, with the value category of the tuple.
+template <typename Tuple, typename Visitor> struct tuple_element_visitor {
+    Tuple &&tuple;
+    Visitor &&visitor;
+
+    template <std::size_t I>
+    INTEGRAL_SWITCH_ALWAYS_INLINE auto operator()(std::integral_constant<std::size_t, I>) const
+        -> decltype(std::forward<Visitor>(visitor)(std::get<I>(std::forward<Tuple>(tuple)))) {
+        return std::forward<Visitor>(visitor)(std::get<I>(std::forward<Tuple>(tuple)));
+    }
+};
+
+template <typename Tuple>
+using tuple_index_switch = make_integral_switch<
+    make_index_sequence<std::tuple_size<typename std::decay<Tuple>::type>::value>>;
+
+// The miss policy of the index switch of the tuple unless another Policy than void is given.
+template <typename Policy, typename Tuple>
+using tuple_miss_policy =
+    typename std::conditional<std::is_void<Policy>::value,
+                              typename miss_policy<tuple_index_switch<Tuple>>::type, Policy>::type;
+
+template <typename Tuple, typename Visitor>
+using tuple_visit_result = typename tuple_index_switch<Tuple>::template return_type<
+    tuple_element_visitor<Tuple, Visitor>>;
+
+} // namespace detail
+
+// Calls visitor(std::get<I>(tuple)) for the runtime index i, with the element passed by reference
+// and never copied. Works with anything that has std::tuple_size and std::get, e.g. std::tuple,
+// std::pair and std::array. The visitor must return the same type for every element. The indices
+// 0 to N - 1 are dense keys of an integral_switch, so compilers dispatch on i with one bounds check
+// and a jump table. Indices out of range are handled by the Policy, which defaults to the miss
+// policy of that integral_switch.
+template <typename Policy = void, typename Tuple, typename Visitor>
+INTEGRAL_SWITCH_ALWAYS_INLINE detail::tuple_visit_result<Tuple, Visitor>
+visit_tuple_at(Tuple &&tuple, std::size_t i, Visitor &&visitor) {
+    static_assert(std::tuple_size<typename std::decay<Tuple>::type>::value > 0,
+                  "the tuple must not be empty");
+
+    detail::tuple_element_visitor<Tuple, Visitor> wrapper{std::forward<Tuple>(tuple),
+                                                          std::forward<Visitor>(visitor)};
+
+    using policy = detail::tuple_miss_policy<Policy, Tuple>;
+
+    return detail::tuple_index_switch<Tuple>::template visit<policy>(wrapper, i);
+}
+
+// Calls visitor(std::get<i>(tuple)) for every index i of the range indices in order, e.g. for the
+// columns of a file in the order of its header.
+template <typename Policy = void, typename Tuple, typename Indices, typename Visitor>
+void for_each_tuple_index(Tuple &&tuple, const Indices &indices, Visitor &&visitor) {
+    for (const auto i : indices) {
+        visit_tuple_at<Policy>(tuple, static_cast<std::size_t>(i), visitor);
+    }
+}
+
+} // namespace integral_switch
+
+#endif
@@ -19,40 +19,85 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 """
 
 import os
+import glob
+import argparse
 import subprocess
 import io
 import pandas as pd
 import matplotlib.pyplot as plt
 from jinja2 import Environment, BaseLoader
 
-build_path = os.path.join("build-clang-6.0-14")
 
-benchmark = os.path.join(build_path, "test", "benchmark_switch")
-
-out = subprocess.check_output([benchmark, "--benchmark_format=csv"])
-stream = io.StringIO(out.decode())
-stream.seek(0)
-df = pd.read_csv(stream)
-
-df["implementation"] = df["name"].apply(lambda x: x.split("<")[0])
-df["number"] = df["name"].apply(lambda x: int(x.split("<")[1].split(">")[0]))
-
-plt.style.use("ggplot")
-plt.figure(figsize=(16, 12))
-for implementation, group in df.groupby("implementation"):
-    plt.plot(group["number"], group["cpu_time"], "o-", label=implementation)
-plt.legend()
-
-graph = "benchmark_switch.png"
-plt.savefig(os.path.join("script", graph))
-
-intervals = df[df["number"].isin({4, 8, 16, 32, 64, 128})]
-table = intervals.pivot(index="implementation", columns="number")[
-    "cpu_time"
-].to_string()
-print(table)
-
-benchmark_md = """
+def run_benchmark(benchmark):
+    out = subprocess.check_output([benchmark, "--benchmark_format=csv"])
+    stream = io.StringIO(out.decode())
+    stream.seek(0)
+    df = pd.read_csv(stream)
+
+    df["implementation"] = df["name"].apply(lambda x: x.split("<")[0])
+    df["number"] = df["name"].apply(lambda x: int(x.split("<")[1].split(">")[0]))
+    return df
+
+
+def plot(df, graph):
+    plt.style.use("ggplot")
+    plt.figure(figsize=(16, 12))
+    for implementation, group in df.groupby("implementation"):
+        plt.plot(group["number"], group["cpu_time"], "o-", label=implementation)
+    plt.legend()
+    plt.savefig(os.path.join("script", graph))
+
+
+def sweep(build_path):
+    """Runs the benchmark_switch_<layout>_<width> binaries built with
+    INTEGRAL_SWITCH_BENCHMARK_SWEEP=ON and compares the chunk widths."""
+    frames = []
+    pattern = os.path.join(build_path, "test", "benchmark_switch_*_*")
+    for benchmark in sorted(glob.glob(pattern)):
+        layout, width = os.path.basename(benchmark).split("_")[-2:]
+        df = run_benchmark(benchmark)
+        df = df[df["implementation"] == "integral_switch_visit_nothrow"].copy()
+        df["implementation"] = "{}_{}".format(layout, width)
+        frames.append(df)
+
+    df = pd.concat(frames)
+    plot(df, "benchmark_sweep.png")
+
+    summary = df.groupby("implementation")["cpu_time"].describe()
+    print(summary[["mean", "50%", "max"]].sort_values("mean").to_string())
+
+
+if __name__ == "__main__":
+    cmd = argparse.ArgumentParser(description=__doc__)
+    cmd.add_argument(
+        "--build-path",
+        default="build-clang-6.0-14",
+        help="Directory where integral_switch was built",
+    )
+    cmd.add_argument(
+        "--sweep",
+        action="store_true",
+        help="Compare chunk widths instead of updating benchmark.md",
+    )
+    args = cmd.parse_args()
+
+    if args.sweep:
+        sweep(args.build_path)
+        raise SystemExit
+
+    benchmark = os.path.join(args.build_path, "test", "benchmark_switch")
+    df = run_benchmark(benchmark)
+
+    graph = "benchmark_switch.png"
+    plot(df, graph)
+
+    intervals = df[df["number"].isin({4, 8, 16, 32, 64, 128})]
+    table = intervals.pivot(index="implementation", columns="number")[
+        "cpu_time"
+    ].to_string()
+    print(table)
+
+    benchmark_md = """
 # Benchmarks
 
 Benchmarking is done against "hand-rolled" switch-case statements. The benchmark problem is inspired by mpark variant's [execute.mpark.cpp](https://github.com/mpark/variant/blob/benchmark/visit.1/execute.mpark.cpp)
@@ -64,11 +109,11 @@ Benchmarking is done against "hand-rolled" switch-case statements. The benchmark
 ```
 """
 
-rendered = (
-    Environment(loader=BaseLoader)
-    .from_string(benchmark_md)
-    .render(graph=graph, table=table)
-)
+    rendered = (
+        Environment(loader=BaseLoader)
+        .from_string(benchmark_md)
+        .render(graph=graph, table=table)
+    )
 
-with open("script/benchmark.md", "w") as fd:
-    print(rendered, file=fd)
+    with open("script/benchmark.md", "w") as fd:
+        print(rendered, file=fd)
@@ -45,9 +45,13 @@ if __name__ == "__main__":
         nargs="?",
         type=int,
         default=32,
-        help="The height of the switch case statement",
+        help="The height of the switch case statement, i.e. the chunk width of integral_switch",
     )
-    choices = ["integral_switch.tmpl", "benchmark_switch.tmpl"]
+    choices = [
+        "integral_switch.tmpl",
+        "integral_switch_tree.tmpl",
+        "benchmark_switch.tmpl",
+    ]
     cmd.add_argument(
         "--template",
         choices=choices,
@@ -57,6 +61,10 @@ if __name__ == "__main__":
     cmd.add_argument(
         "--clangformatbin", default="clang-format", help="Path to clang-format binary"
     )
+    cmd.add_argument(
+        "--no-format", action="store_true", help="Do not run clang-format on the output"
+    )
+    cmd.add_argument("--output", help="Write to this file instead of stdout")
     args = cmd.parse_args()
     dirname = os.path.dirname(__file__)
     env = Environment(loader=FileSystemLoader(dirname))
@@ -67,5 +75,9 @@ if __name__ == "__main__":
             yield fmt.format(i)
 
     out = template.render(number=args.number, formatRange=formatRange)
-    formatted = clangFormat(args.clangformatbin, out)
-    print(formatted)
+    formatted = out if args.no_format else clangFormat(args.clangformatbin, out)
+    if args.output:
+        with open(args.output, "w") as fd:
+            print(formatted, file=fd)
+    else:
+        print(formatted)
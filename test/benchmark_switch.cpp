@@ -17,23 +17,46 @@
  */
 
 #include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <queue>
+#include <string>
+#include <system_error>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "benchmark_switch.h"
+#include "batch_encoder.h"
+#include "dynamic_switch.h"
 #include "integral_switch.h"
+#include "kernel_switch.h"
+#include "mpsc_queue.h"
+#include "parallel_switch.h"
+#include "pattern_switch.h"
+#include "range_switch.h"
+#include "rcu_switch.h"
+#include "string_switch.h"
+#include "switch_stats.h"
+#include "switch_latency.h"
 
 namespace integral_switch {
 
 template <std::size_t I> using size_constant = std::integral_constant<std::size_t, I>;
 
 template <std::size_t... Is> std::vector<size_t> make_ids(detail::index_sequence<Is...>) {
+    const std::size_t keys[] = {Is...};
     std::vector<std::size_t> vs;
 
-    for (std::size_t i = 0; i < 5000 / sizeof...(Is); ++i) {
-        int dummy[] = {(vs.push_back(Is), 0)...};
-        (void)dummy;
-    }
+    std::size_t i = 0;
+
+    do {
+        vs.insert(vs.end(), std::begin(keys), std::end(keys));
+    } while (++i < 5000 / sizeof...(Is));
 
     return vs;
 }
@@ -66,6 +89,24 @@ template <std::size_t N> static void integral_switch_visit_nothrow(benchmark::St
     }
 }
 
+template <std::size_t N> static void integral_switch_visit_unchecked(benchmark::State &state) {
+    using Seq = detail::make_index_sequence<N>;
+
+    auto ids = make_ids(Seq{});
+
+    Visitor1 visitor1;
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+        using Switch = typename MakeSwitch<Seq>::type;
+
+        for (const auto i : ids) {
+            sum += Switch::visit_unchecked(visitor1, i);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
 template <std::size_t N> static void switch_case_visit_nothrow(benchmark::State &state) {
     using Seq = detail::make_index_sequence<N>;
 
@@ -81,8 +122,101 @@ template <std::size_t N> static void switch_case_visit_nothrow(benchmark::State
     }
 }
 
+// Dispatch with a given miss policy. Only hits are measured, so the differences come from code
+// layout and from the error paths the compiler has to keep around.
+template <typename Policy, std::size_t N> static void visit_with_policy(benchmark::State &state) {
+    using Seq = detail::make_index_sequence<N>;
+    using Switch = typename MakeSwitch<Seq>::type;
+
+    auto ids = make_ids(Seq{});
+
+    Visitor1 visitor1;
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+
+        for (const auto i : ids) {
+            sum += Switch::template visit<Policy>(visitor1, i);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+template <std::size_t N> static void visit_throw_on_miss(benchmark::State &state) {
+    visit_with_policy<throw_on_miss, N>(state);
+}
+
+template <std::size_t N> static void visit_abort_on_miss(benchmark::State &state) {
+    visit_with_policy<abort_on_miss, N>(state);
+}
+
+template <std::size_t N> static void visit_error_code(benchmark::State &state) {
+    using Seq = detail::make_index_sequence<N>;
+    using Switch = typename MakeSwitch<Seq>::type;
+
+    auto ids = make_ids(Seq{});
+
+    Visitor1 visitor1;
+    std::error_code ec;
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+
+        for (const auto i : ids) {
+            sum += Switch::visit(visitor1, i, ec);
+        }
+        benchmark::DoNotOptimize(sum);
+        benchmark::DoNotOptimize(ec);
+    }
+}
+
+// visit() that counts hits and misses in switch_stats, to compare with visit_throw_on_miss.
+template <std::size_t N> static void visit_counted_hits(benchmark::State &state) {
+    using Seq = detail::make_index_sequence<N>;
+    using Switch = typename MakeSwitch<Seq>::type;
+
+    auto ids = make_ids(Seq{});
+
+    Visitor1 visitor1;
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+
+        for (const auto i : ids) {
+            sum += visit_counted<Switch>(visitor1, i);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+// visit() that times one call in INTEGRAL_SWITCH_LATENCY_SAMPLE into switch_latency.
+template <std::size_t N> static void visit_timed_sampled(benchmark::State &state) {
+    using Seq = detail::make_index_sequence<N>;
+    using Switch = typename MakeSwitch<Seq>::type;
+
+    auto ids = make_ids(Seq{});
+
+    Visitor1 visitor1;
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+
+        for (const auto i : ids) {
+            sum += visit_timed<Switch>(visitor1, i);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+// Key sets larger than INTEGRAL_SWITCH_TABLE_THRESHOLD are dispatched through flat tables, whose
+// latency should not grow with the number of keys.
+template <std::size_t N> static void table_switch_visit_nothrow(benchmark::State &state) {
+    integral_switch_visit_nothrow<N>(state);
+}
+
 #define BENCHMARK_INTEGRAL_SWITCH(N)                                                               \
     BENCHMARK_TEMPLATE(integral_switch_visit_nothrow, N);                                          \
+    BENCHMARK_TEMPLATE(integral_switch_visit_unchecked, N);                                        \
     BENCHMARK_TEMPLATE(switch_case_visit_nothrow, N);
 
 BENCHMARK_INTEGRAL_SWITCH(3);
@@ -218,4 +352,790 @@ BENCHMARK_INTEGRAL_SWITCH(132);
 
 #undef BENCHMARK_INTEGRAL_SWITCH
 
+// Every case does enough work that inlining all of them makes the calling loop much larger than
+// the L1 instruction cache's share of a hot function. Run with
+// --benchmark_perf_counters=L1-icache-load-misses to compare the miss counts.
+struct HeavyVisitor {
+    template <std::size_t I> std::size_t operator()(size_constant<I>) const {
+        std::size_t h = I;
+
+        for (std::size_t j = 0; j < 16; ++j) {
+            h = (h * (2 * I + 1)) ^ (h >> (I % 7 + 1));
+        }
+
+        return h;
+    }
+};
+
+template <std::size_t N> static void heavy_visit_nothrow(benchmark::State &state) {
+    using Seq = detail::make_index_sequence<N>;
+    using Switch = typename MakeSwitch<Seq>::type;
+
+    auto ids = make_ids(Seq{});
+
+    HeavyVisitor visitor;
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+
+        for (const auto i : ids) {
+            sum += Switch::visit_nothrow(visitor, i, 0);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+template <std::size_t N> static void heavy_visit_nothrow_outlined(benchmark::State &state) {
+    using Seq = detail::make_index_sequence<N>;
+    using Switch = typename MakeSwitch<Seq>::type;
+
+    auto ids = make_ids(Seq{});
+
+    HeavyVisitor visitor;
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+
+        for (const auto i : ids) {
+            sum += Switch::visit_nothrow(outline(visitor), i, 0);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+BENCHMARK_TEMPLATE(heavy_visit_nothrow, 16);
+BENCHMARK_TEMPLATE(heavy_visit_nothrow_outlined, 16);
+BENCHMARK_TEMPLATE(heavy_visit_nothrow, 64);
+BENCHMARK_TEMPLATE(heavy_visit_nothrow_outlined, 64);
+BENCHMARK_TEMPLATE(heavy_visit_nothrow, 128);
+BENCHMARK_TEMPLATE(heavy_visit_nothrow_outlined, 128);
+
+BENCHMARK_TEMPLATE(table_switch_visit_nothrow, 512);
+BENCHMARK_TEMPLATE(table_switch_visit_nothrow, 1000);
+BENCHMARK_TEMPLATE(table_switch_visit_nothrow, 3000);
+BENCHMARK_TEMPLATE(table_switch_visit_nothrow, 10000);
+
+BENCHMARK_TEMPLATE(visit_throw_on_miss, 32);
+BENCHMARK_TEMPLATE(visit_abort_on_miss, 32);
+BENCHMARK_TEMPLATE(visit_error_code, 32);
+BENCHMARK_TEMPLATE(visit_counted_hits, 32);
+BENCHMARK_TEMPLATE(visit_timed_sampled, 32);
+
+template <typename> struct MakeDynamicSwitch;
+
+template <std::size_t... Is> struct MakeDynamicSwitch<detail::index_sequence<Is...>> {
+    using type = dynamic_switch<std::size_t(), std::size_t, Is...>;
+};
+
+struct Handler {
+    std::size_t value;
+
+    std::size_t operator()() const { return value; }
+};
+
+// Handlers bound at runtime, called through a dynamic_switch or looked up in a hash map of
+// std::function.
+template <std::size_t N> static void dynamic_switch_visit(benchmark::State &state) {
+    using Seq = detail::make_index_sequence<N>;
+    using Switch = typename MakeDynamicSwitch<Seq>::type;
+
+    auto ids = make_ids(Seq{});
+
+    Switch s;
+
+    for (std::size_t i = 0; i < N; ++i) {
+        s.bind(i, Handler{i});
+    }
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+
+        for (const auto i : ids) {
+            sum += s.visit(i);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+template <std::size_t N> static void unordered_map_function_visit(benchmark::State &state) {
+    auto ids = make_ids(detail::make_index_sequence<N>{});
+
+    std::unordered_map<std::size_t, std::function<std::size_t()>> handlers;
+
+    for (std::size_t i = 0; i < N; ++i) {
+        handlers.emplace(i, Handler{i});
+    }
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+
+        for (const auto i : ids) {
+            sum += handlers.find(i)->second();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+template <typename> struct MakeRcuSwitch;
+
+template <std::size_t... Is> struct MakeRcuSwitch<detail::index_sequence<Is...>> {
+    using type = rcu_switch<std::size_t(), std::size_t, Is...>;
+};
+
+// rcu_switch enters a read-side critical section per call, or once per batch under a read_guard.
+template <std::size_t N, bool Batch> static void rcu_switch_visit_impl(benchmark::State &state) {
+    using Seq = detail::make_index_sequence<N>;
+    using Switch = typename MakeRcuSwitch<Seq>::type;
+
+    auto ids = make_ids(Seq{});
+
+    Switch s;
+
+    for (std::size_t i = 0; i < N; ++i) {
+        s.bind(i, Handler{i});
+    }
+
+    auto reader = s.make_reader();
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+
+        if (Batch) {
+            reader.lock();
+        }
+
+        for (const auto i : ids) {
+            sum += reader.visit(i);
+        }
+
+        if (Batch) {
+            reader.unlock();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+template <std::size_t N> static void rcu_switch_visit(benchmark::State &state) {
+    rcu_switch_visit_impl<N, false>(state);
+}
+
+template <std::size_t N> static void rcu_switch_visit_batch(benchmark::State &state) {
+    rcu_switch_visit_impl<N, true>(state);
+}
+
+template <std::size_t I> struct Event {
+    std::size_t value;
+};
+
+struct SumEvents {
+    std::size_t &sum;
+
+    template <std::size_t I> void operator()(const Event<I> &e) const { sum += e.value * (I + 1); }
+};
+
+// N events of four types pushed into and drained from an mpsc_queue, compared with a std::queue of
+// heap allocated events with virtual dispatch.
+template <std::size_t N> static void mpsc_queue_dispatch(benchmark::State &state) {
+    mpsc_queue<N * 64, Event<0>, Event<1>, Event<2>, Event<3>> queue;
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+
+        for (std::size_t i = 0; i < N; i += 4) {
+            queue.try_push(Event<0>{i});
+            queue.try_push(Event<1>{i});
+            queue.try_push(Event<2>{i});
+            queue.try_push(Event<3>{i});
+        }
+        queue.consume(SumEvents{sum});
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+struct VirtualEvent {
+    virtual ~VirtualEvent() = default;
+    virtual void apply(std::size_t &sum) const = 0;
+};
+
+template <std::size_t I> struct VirtualEventOf : VirtualEvent {
+    explicit VirtualEventOf(std::size_t v) : value(v) {}
+
+    void apply(std::size_t &sum) const override { sum += value * (I + 1); }
+
+    std::size_t value;
+};
+
+template <std::size_t N> static void virtual_queue_dispatch(benchmark::State &state) {
+    std::queue<std::unique_ptr<VirtualEvent>> queue;
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+
+        for (std::size_t i = 0; i < N; i += 4) {
+            queue.emplace(new VirtualEventOf<0>(i));
+            queue.emplace(new VirtualEventOf<1>(i));
+            queue.emplace(new VirtualEventOf<2>(i));
+            queue.emplace(new VirtualEventOf<3>(i));
+        }
+
+        while (!queue.empty()) {
+            queue.front()->apply(sum);
+            queue.pop();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+struct SumVisitor {
+    std::size_t sum;
+
+    template <std::size_t I> void operator()(size_constant<I>, std::size_t) { sum += I; }
+
+    void merge(const SumVisitor &other) { sum += other.sum; }
+};
+
+// One million keys visited by a work_stealing_pool with as many workers as the argument, to show
+// the speedup over visiting them on one thread.
+template <std::size_t N> static void visit_batch_parallel_threads(benchmark::State &state) {
+    using Seq = detail::make_index_sequence<N>;
+    using Switch = typename MakeSwitch<Seq>::type;
+
+    std::vector<std::size_t> ids;
+
+    while (ids.size() < 1000000) {
+        const auto some = make_ids(Seq{});
+        ids.insert(ids.end(), some.begin(), some.end());
+    }
+
+    work_stealing_pool pool(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        auto result = visit_batch_parallel<Switch>(SumVisitor{0}, ids.data(), ids.size(), pool);
+        benchmark::DoNotOptimize(result.sum);
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * ids.size()));
+}
+
+// The I-th of the keys "keyaa", "keyba", ... as a string_key and as a std::string.
+template <std::size_t I>
+using StringKey = string_key<'k', 'e', 'y', static_cast<char>('a' + I % 26),
+                             static_cast<char>('a' + I / 26 % 26)>;
+
+std::string key_string(std::size_t i) {
+    return std::string("key") + static_cast<char>('a' + i % 26) +
+           static_cast<char>('a' + i / 26 % 26);
+}
+
+template <typename Seq> std::vector<std::string> make_strings(Seq seq) {
+    std::vector<std::string> strings;
+
+    for (const auto i : make_ids(seq)) {
+        strings.push_back(key_string(i));
+    }
+    return strings;
+}
+
+template <typename> struct MakeStringSwitch;
+
+template <std::size_t... Is> struct MakeStringSwitch<detail::index_sequence<Is...>> {
+    using type = basic_string_switch<StringKey<Is>...>;
+};
+
+struct StringVisitor {
+    template <typename Key> std::size_t operator()(Key) const {
+        return static_cast<std::size_t>(Key::data[3] - 'a' + (Key::data[4] - 'a') * 26);
+    }
+};
+
+// Short strings dispatched with a string_switch, compared with a chain of == and with a hash map
+// of std::function.
+template <std::size_t N> static void string_switch_visit(benchmark::State &state) {
+    using Seq = detail::make_index_sequence<N>;
+    using Switch = typename MakeStringSwitch<Seq>::type;
+
+    const auto strings = make_strings(Seq{});
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+
+        for (const auto &s : strings) {
+            sum += Switch::visit(StringVisitor{}, s);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+template <std::size_t N> static void if_else_string_visit(benchmark::State &state) {
+    using Seq = detail::make_index_sequence<N>;
+
+    const auto strings = make_strings(Seq{});
+
+    std::vector<std::string> chain;
+
+    for (std::size_t i = 0; i < N; ++i) {
+        chain.push_back(key_string(i));
+    }
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+
+        for (const auto &s : strings) {
+            for (std::size_t i = 0; i < N; ++i) {
+                if (s == chain[i]) {
+                    sum += i;
+                    break;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+template <std::size_t N> static void unordered_map_string_visit(benchmark::State &state) {
+    const auto strings = make_strings(detail::make_index_sequence<N>{});
+
+    std::unordered_map<std::string, std::function<std::size_t()>> handlers;
+
+    for (std::size_t i = 0; i < N; ++i) {
+        handlers.emplace(key_string(i), Handler{i});
+    }
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+
+        for (const auto &s : strings) {
+            sum += handlers.find(s)->second();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+template <typename> struct MakeRangeSwitch;
+
+template <std::size_t... Is> struct MakeRangeSwitch<detail::index_sequence<Is...>> {
+    using type = range_switch<int, static_cast<int>(Is * 64)...>;
+};
+
+// Values spread over N intervals of width 64 in an order the branch predictor cannot learn.
+std::vector<int> make_range_values(std::size_t n) {
+    std::vector<int> values;
+
+    for (std::size_t i = 0; i < 5000; ++i) {
+        values.push_back(static_cast<int>(i * 2654435761u % (n * 64)));
+    }
+    return values;
+}
+
+// N intervals classified with a range_switch, compared with a chain of comparisons that stops at
+// the first interval that contains the value and with std::upper_bound.
+template <std::size_t N> static void range_switch_visit(benchmark::State &state) {
+    using Switch = typename MakeRangeSwitch<detail::make_index_sequence<N + 1>>::type;
+
+    const auto values = make_range_values(N);
+
+    Visitor1 visitor1;
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+
+        for (const auto v : values) {
+            sum += Switch::visit(visitor1, v);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+template <std::size_t N> static void if_chain_range_visit(benchmark::State &state) {
+    const auto values = make_range_values(N);
+
+    std::vector<int> bounds;
+
+    for (std::size_t i = 1; i <= N; ++i) {
+        bounds.push_back(static_cast<int>(i * 64));
+    }
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+
+        for (const auto v : values) {
+            for (std::size_t i = 0; i < N; ++i) {
+                if (v < bounds[i]) {
+                    sum += i;
+                    break;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+template <std::size_t N> static void upper_bound_range_visit(benchmark::State &state) {
+    const auto values = make_range_values(N);
+
+    std::vector<int> bounds;
+
+    for (std::size_t i = 0; i <= N; ++i) {
+        bounds.push_back(static_cast<int>(i * 64));
+    }
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+
+        for (const auto v : values) {
+            sum += static_cast<std::size_t>(std::upper_bound(bounds.begin(), bounds.end(), v) -
+                                            bounds.begin()) -
+                   1;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+#ifdef USE_CPP_14_CONSTEXPR
+// The RV32I base instructions, told apart by their opcode field, funct3 and funct7.
+using OpLui = pattern<std::uint32_t, 0x0000007f, 0x00000037>;
+using OpAuipc = pattern<std::uint32_t, 0x0000007f, 0x00000017>;
+using OpJal = pattern<std::uint32_t, 0x0000007f, 0x0000006f>;
+using OpJalr = pattern<std::uint32_t, 0x0000707f, 0x00000067>;
+using OpBeq = pattern<std::uint32_t, 0x0000707f, 0x00000063>;
+using OpBne = pattern<std::uint32_t, 0x0000707f, 0x00001063>;
+using OpBlt = pattern<std::uint32_t, 0x0000707f, 0x00004063>;
+using OpBge = pattern<std::uint32_t, 0x0000707f, 0x00005063>;
+using OpBltu = pattern<std::uint32_t, 0x0000707f, 0x00006063>;
+using OpBgeu = pattern<std::uint32_t, 0x0000707f, 0x00007063>;
+using OpLb = pattern<std::uint32_t, 0x0000707f, 0x00000003>;
+using OpLh = pattern<std::uint32_t, 0x0000707f, 0x00001003>;
+using OpLw = pattern<std::uint32_t, 0x0000707f, 0x00002003>;
+using OpLbu = pattern<std::uint32_t, 0x0000707f, 0x00004003>;
+using OpLhu = pattern<std::uint32_t, 0x0000707f, 0x00005003>;
+using OpSb = pattern<std::uint32_t, 0x0000707f, 0x00000023>;
+using OpSh = pattern<std::uint32_t, 0x0000707f, 0x00001023>;
+using OpSw = pattern<std::uint32_t, 0x0000707f, 0x00002023>;
+using OpAddi = pattern<std::uint32_t, 0x0000707f, 0x00000013>;
+using OpSlti = pattern<std::uint32_t, 0x0000707f, 0x00002013>;
+using OpSltiu = pattern<std::uint32_t, 0x0000707f, 0x00003013>;
+using OpXori = pattern<std::uint32_t, 0x0000707f, 0x00004013>;
+using OpOri = pattern<std::uint32_t, 0x0000707f, 0x00006013>;
+using OpAndi = pattern<std::uint32_t, 0x0000707f, 0x00007013>;
+using OpSlli = pattern<std::uint32_t, 0xfe00707f, 0x00001013>;
+using OpSrli = pattern<std::uint32_t, 0xfe00707f, 0x00005013>;
+using OpSrai = pattern<std::uint32_t, 0xfe00707f, 0x40005013>;
+using OpAdd = pattern<std::uint32_t, 0xfe00707f, 0x00000033>;
+using OpSub = pattern<std::uint32_t, 0xfe00707f, 0x40000033>;
+using OpSll = pattern<std::uint32_t, 0xfe00707f, 0x00001033>;
+using OpSlt = pattern<std::uint32_t, 0xfe00707f, 0x00002033>;
+using OpSltu = pattern<std::uint32_t, 0xfe00707f, 0x00003033>;
+using OpXor = pattern<std::uint32_t, 0xfe00707f, 0x00004033>;
+using OpSrl = pattern<std::uint32_t, 0xfe00707f, 0x00005033>;
+using OpSra = pattern<std::uint32_t, 0xfe00707f, 0x40005033>;
+using OpOr = pattern<std::uint32_t, 0xfe00707f, 0x00006033>;
+using OpAnd = pattern<std::uint32_t, 0xfe00707f, 0x00007033>;
+
+using Decoder =
+    pattern_switch<OpLui, OpAuipc, OpJal, OpJalr, OpBeq, OpBne, OpBlt, OpBge, OpBltu, OpBgeu, OpLb,
+                   OpLh, OpLw, OpLbu, OpLhu, OpSb, OpSh, OpSw, OpAddi, OpSlti, OpSltiu, OpXori,
+                   OpOri, OpAndi, OpSlli, OpSrli, OpSrai, OpAdd, OpSub, OpSll, OpSlt, OpSltu, OpXor,
+                   OpSrl, OpSra, OpOr, OpAnd>;
+
+// The (mask, value) pairs of the patterns of a pattern_switch, in order.
+template <typename> struct PatternTable;
+
+template <typename... Ps> struct PatternTable<pattern_switch<Ps...>> {
+    static constexpr std::size_t size = sizeof...(Ps);
+
+    using masks = detail::key_array<std::uint32_t, Ps::mask...>;
+    using values = detail::key_array<std::uint32_t, Ps::value...>;
+};
+
+struct PatternVisitor {
+    template <typename P> std::size_t operator()(P) const { return P::value & 0x7f; }
+};
+
+// Instructions of the patterns above with random don't-care bits.
+std::vector<std::uint32_t> make_instructions() {
+    std::vector<std::uint32_t> instructions;
+    std::uint32_t x = 1;
+
+    for (std::size_t i = 0; i < 5000; ++i) {
+        x = x * 1664525u + 1013904223u;
+
+        const std::size_t p = (x >> 8) % PatternTable<Decoder>::size;
+
+        instructions.push_back((x & ~PatternTable<Decoder>::masks::values[p]) |
+                               PatternTable<Decoder>::values::values[p]);
+    }
+    return instructions;
+}
+
+// Instructions decoded with a pattern_switch, compared with a scan of the (mask, value) pairs that
+// stops at the first match.
+static void pattern_switch_decode(benchmark::State &state) {
+    const auto instructions = make_instructions();
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+
+        for (const auto x : instructions) {
+            sum += Decoder::visit(PatternVisitor{}, x);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+static void linear_scan_decode(benchmark::State &state) {
+    using table = PatternTable<Decoder>;
+
+    const auto instructions = make_instructions();
+
+    for (auto _ : state) {
+        std::size_t sum = 0;
+
+        for (const auto x : instructions) {
+            for (std::size_t i = 0; i < table::size; ++i) {
+                if ((x & table::masks::values[i]) == table::values::values[i]) {
+                    sum += table::values::values[i] & 0x7f;
+                    break;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+#endif
+
+// Transforms an element, or a whole array, with a function that depends on the key I.
+struct AffineElement {
+    int x;
+
+    template <std::size_t I> int operator()(size_constant<I>) const {
+        return x * static_cast<int>(I + 1) + static_cast<int>(I);
+    }
+};
+
+struct AffineArray {
+    template <std::size_t I>
+    void operator()(size_constant<I>, const int *in, int *out, std::size_t n) const {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = AffineElement{in[i]}(size_constant<I>{});
+        }
+    }
+};
+
+// An array transformed with a key that stays the same over the array, dispatched for every
+// element, compared with resolving the key once into a function that loops over the array.
+template <std::size_t N> static void visit_per_element(benchmark::State &state) {
+    using Switch = typename MakeSwitch<detail::make_index_sequence<N>>::type;
+
+    std::vector<int> in(4096, 3);
+    std::vector<int> out(in.size());
+    std::size_t key = N / 2;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(key);
+
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            out[i] = Switch::visit(AffineElement{in[i]}, key);
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+}
+
+template <std::size_t N> static void resolve_once(benchmark::State &state) {
+    using Switch = typename MakeSwitch<detail::make_index_sequence<N>>::type;
+
+    std::vector<int> in(4096, 3);
+    std::vector<int> out(in.size());
+    std::size_t key = N / 2;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(key);
+
+        Switch::template resolve<void(const int *, int *, std::size_t), AffineArray>(key)(
+            in.data(), out.data(), in.size());
+        benchmark::DoNotOptimize(out.data());
+    }
+}
+
+// Adds two arrays of 1M elements whose dtypes are known at run time: dispatched once per array to
+// a loop for the pair with a kernel_switch, through its generic path for a pair without a loop of
+// its own, and dispatched for every element.
+static void kernel_switch_add(benchmark::State &state) {
+    const std::vector<float> a(1 << 20, 1.0f);
+    const std::vector<float> b(a.size(), 2.0f);
+
+    std::vector<float> out(a.size());
+
+    for (auto _ : state) {
+        kernel_switch<add_kernel>::run(dtype::float32, dtype::float32, a.data(), b.data(),
+                                       out.data(), out.size());
+        benchmark::DoNotOptimize(out.data());
+    }
+}
+
+static void kernel_switch_add_generic(benchmark::State &state) {
+    const std::vector<float> a(1 << 20, 1.0f);
+    const std::vector<float> b(a.size(), 2.0f);
+
+    std::vector<double> out(a.size());
+
+    for (auto _ : state) {
+        kernel_switch<add_kernel>::run(dtype::float32, dtype::float64, a.data(), b.data(),
+                                       out.data(), out.size());
+        benchmark::DoNotOptimize(out.data());
+    }
+}
+
+struct AddElement {
+    const void *a;
+    const void *b;
+    void *out;
+    std::size_t i;
+
+    template <std::size_t K> void operator()(size_constant<K>) const {
+        using In = detail::pair_input<K>;
+        using Out = detail::pair_output<K>;
+
+        static_cast<Out *>(out)[i] =
+            static_cast<Out>(static_cast<const In *>(a)[i] + static_cast<const In *>(b)[i]);
+    }
+};
+
+static void per_element_dtype_add(benchmark::State &state) {
+    const std::vector<float> a(1 << 20, 1.0f);
+    const std::vector<float> b(a.size(), 2.0f);
+
+    std::vector<float> out(a.size());
+    dtype in = dtype::float32;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(in);
+
+        for (std::size_t i = 0; i < out.size(); ++i) {
+            detail::dtype_pair_switch::visit(AddElement{a.data(), b.data(), out.data(), i},
+                                             detail::dtype_pair(in, dtype::float32));
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+}
+
+struct BatchQuote {
+    std::int32_t id;
+    double price;
+};
+
+struct BatchText {
+    std::string text;
+};
+
+std::size_t encoded_size(const BatchText &message) { return message.text.size(); }
+
+char *encode(const BatchText &message, char *out) {
+    std::memcpy(out, message.text.data(), message.text.size());
+    return out + message.text.size();
+}
+
+// N messages, alternately quotes and short texts, encoded into one reused buffer with a
+// batch_encoder, compared with encoding every message into a std::string of its own.
+template <std::size_t N> static void batch_encoder_encode(benchmark::State &state) {
+    std::vector<BatchQuote> quotes(N / 2, BatchQuote{1, 2.0});
+    std::vector<BatchText> texts(N - N / 2, BatchText{"NewOrder"});
+
+    batch_encoder<BatchText, BatchQuote> encoder;
+    std::string buffer;
+
+    encoder.reserve(N);
+
+    for (auto _ : state) {
+        encoder.clear();
+
+        for (std::size_t i = 0; i < N / 2; ++i) {
+            encoder.add(quotes[i]);
+            encoder.add(texts[i]);
+        }
+
+        buffer.clear();
+        encoder.encode_to(buffer);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+}
+
+template <std::size_t N> static void string_per_message_encode(benchmark::State &state) {
+    std::vector<BatchQuote> quotes(N / 2, BatchQuote{1, 2.0});
+    std::vector<BatchText> texts(N - N / 2, BatchText{"NewOrder"});
+
+    std::vector<std::string> messages;
+
+    messages.reserve(N);
+
+    for (auto _ : state) {
+        messages.clear();
+
+        for (std::size_t i = 0; i < N / 2; ++i) {
+            std::string quote(sizeof(batch_header) + sizeof(BatchQuote), '\0');
+            std::string text(sizeof(batch_header) + texts[i].text.size(), '\0');
+
+            detail::write_batch_header(&quote[0], 1, sizeof(BatchQuote));
+            std::memcpy(&quote[sizeof(batch_header)], &quotes[i], sizeof(BatchQuote));
+            detail::write_batch_header(&text[0], 0,
+                                       static_cast<std::uint32_t>(texts[i].text.size()));
+            encode(texts[i], &text[sizeof(batch_header)]);
+
+            messages.push_back(std::move(quote));
+            messages.push_back(std::move(text));
+        }
+        benchmark::DoNotOptimize(messages.data());
+    }
+}
+
+BENCHMARK_TEMPLATE(visit_batch_parallel_threads, 64)
+    ->RangeMultiplier(2)
+    ->Range(1, 64)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(mpsc_queue_dispatch, 256);
+BENCHMARK_TEMPLATE(virtual_queue_dispatch, 256);
+
+BENCHMARK_TEMPLATE(dynamic_switch_visit, 8);
+BENCHMARK_TEMPLATE(unordered_map_function_visit, 8);
+BENCHMARK_TEMPLATE(dynamic_switch_visit, 64);
+BENCHMARK_TEMPLATE(unordered_map_function_visit, 64);
+BENCHMARK_TEMPLATE(dynamic_switch_visit, 512);
+BENCHMARK_TEMPLATE(unordered_map_function_visit, 512);
+BENCHMARK_TEMPLATE(rcu_switch_visit, 64);
+BENCHMARK_TEMPLATE(rcu_switch_visit_batch, 64);
+
+BENCHMARK_TEMPLATE(string_switch_visit, 8);
+BENCHMARK_TEMPLATE(if_else_string_visit, 8);
+BENCHMARK_TEMPLATE(unordered_map_string_visit, 8);
+BENCHMARK_TEMPLATE(string_switch_visit, 32);
+BENCHMARK_TEMPLATE(if_else_string_visit, 32);
+BENCHMARK_TEMPLATE(unordered_map_string_visit, 32);
+BENCHMARK_TEMPLATE(string_switch_visit, 300);
+BENCHMARK_TEMPLATE(unordered_map_string_visit, 300);
+
+BENCHMARK_TEMPLATE(range_switch_visit, 8);
+BENCHMARK_TEMPLATE(if_chain_range_visit, 8);
+BENCHMARK_TEMPLATE(upper_bound_range_visit, 8);
+BENCHMARK_TEMPLATE(range_switch_visit, 32);
+BENCHMARK_TEMPLATE(if_chain_range_visit, 32);
+BENCHMARK_TEMPLATE(upper_bound_range_visit, 32);
+BENCHMARK_TEMPLATE(range_switch_visit, 128);
+BENCHMARK_TEMPLATE(if_chain_range_visit, 128);
+BENCHMARK_TEMPLATE(upper_bound_range_visit, 128);
+
+#ifdef USE_CPP_14_CONSTEXPR
+BENCHMARK(pattern_switch_decode);
+BENCHMARK(linear_scan_decode);
+#endif
+
+BENCHMARK_TEMPLATE(visit_per_element, 16);
+BENCHMARK_TEMPLATE(resolve_once, 16);
+
+BENCHMARK(kernel_switch_add);
+BENCHMARK(kernel_switch_add_generic);
+BENCHMARK(per_element_dtype_add);
+
+BENCHMARK_TEMPLATE(batch_encoder_encode, 64);
+BENCHMARK_TEMPLATE(string_per_message_encode, 64);
+
 } // namespace integral_switch
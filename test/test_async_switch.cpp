@@ -0,0 +1,153 @@
+/*
+ * test_async_switch.cpp
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <type_traits>
+
+#include "async_switch.h"
+
+namespace integral_switch {
+
+#ifdef USE_CPP_20_COROUTINES
+
+// A lazily started task that resumes its awaiter when it finishes.
+template <typename T> struct task {
+    struct promise_type : arena_allocated {
+        T value{};
+        std::coroutine_handle<> continuation;
+
+        task get_return_object() {
+            return task{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        auto final_suspend() noexcept {
+            struct resume_continuation {
+                bool await_ready() noexcept { return false; }
+
+                std::coroutine_handle<>
+                await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                    auto c = h.promise().continuation;
+                    return c ? c : std::noop_coroutine();
+                }
+
+                void await_resume() noexcept {}
+            };
+
+            return resume_continuation{};
+        }
+
+        void return_value(T v) { value = v; }
+
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+
+    explicit task(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+    task(task &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+
+    ~task() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    bool await_ready() { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> c) {
+        handle.promise().continuation = c;
+        return handle;
+    }
+
+    T await_resume() { return handle.promise().value; }
+
+    // Runs a task that only suspends on tasks and ready values to completion.
+    T get() {
+        handle.resume();
+        return handle.promise().value;
+    }
+};
+
+// An awaitable that is ready immediately, with a different result type.
+struct ready {
+    long value;
+
+    bool await_ready() { return true; }
+    void await_suspend(std::coroutine_handle<>) {}
+    long await_resume() { return value; }
+};
+
+// An awaitable that decides not to suspend in await_suspend().
+struct not_suspended {
+    bool await_ready() { return false; }
+    bool await_suspend(std::coroutine_handle<>) { return false; }
+    int await_resume() { return 30; }
+};
+
+template <std::size_t I> using size_constant = std::integral_constant<std::size_t, I>;
+
+task<int> times_ten(int x) { co_return x * 10; }
+
+struct AsyncVisitor {
+    task<int> operator()(size_constant<0>) const { return times_ten(1); }
+    ready operator()(size_constant<1>) const { return ready{20}; }
+    not_suspended operator()(size_constant<2>) const { return {}; }
+};
+
+using switch_ = integral_switch<std::size_t, 0, 1, 2>;
+
+static_assert(std::is_same<async_return_type<switch_, AsyncVisitor>::result_type, long>::value,
+              "the result is the common type of the results of the cases");
+
+task<long> dispatch(std::size_t i) { co_return co_await visit_async<switch_>(AsyncVisitor{}, i); }
+
+TEST(test_async_switch, visit_async) {
+    ASSERT_EQ(10, dispatch(0).get());
+    ASSERT_EQ(20, dispatch(1).get());
+    ASSERT_EQ(30, dispatch(2).get());
+    ASSERT_THROW(visit_async<switch_>(AsyncVisitor{}, 3), std::invalid_argument);
+}
+
+TEST(test_async_switch, frame_arena) {
+    frame_arena arena(512, 4);
+
+    ASSERT_EQ(4, arena.available());
+
+    {
+        frame_arena::scope scope(arena);
+        auto t = dispatch(0);
+
+        // The frame of dispatch() is taken from the arena, and so is that of times_ten() while
+        // the task runs.
+        ASSERT_EQ(3, arena.available());
+        ASSERT_EQ(10, t.get());
+    }
+
+    ASSERT_EQ(4, arena.available());
+
+    // Without a current arena frames come from the heap.
+    ASSERT_EQ(20, dispatch(1).get());
+    ASSERT_EQ(4, arena.available());
+}
+
+#endif
+
+} // namespace integral_switch
@@ -0,0 +1,184 @@
+/*
+ * test_batch_encoder.cpp
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "batch_encoder.h"
+
+namespace integral_switch {
+
+struct Quote {
+    std::int32_t id;
+    double price;
+};
+
+struct Text {
+    std::string text;
+};
+
+std::size_t encoded_size(const Text &message) { return message.text.size(); }
+
+char *encode(const Text &message, char *out) {
+    std::memcpy(out, message.text.data(), message.text.size());
+    return out + message.text.size();
+}
+
+using Encoder = batch_encoder<Text, Quote>;
+
+template <typename U, typename = void> struct can_add : std::false_type {};
+
+template <typename U>
+struct can_add<U, decltype(std::declval<Encoder &>().add(std::declval<U>()))> : std::true_type {};
+
+static_assert(can_add<const Quote &>::value, "messages are added by reference");
+static_assert(!can_add<Quote>::value, "the batch would point at a destroyed temporary");
+
+// Describes every record as "tag:payload".
+struct Describe {
+    std::vector<std::string> &records;
+
+    void operator()(type<Quote>, const char *payload, std::size_t size) const {
+        Quote quote;
+
+        ASSERT_EQ(sizeof(Quote), size);
+        std::memcpy(&quote, payload, sizeof(quote));
+        records.push_back("quote:" + std::to_string(quote.id));
+    }
+
+    void operator()(type<Text>, const char *payload, std::size_t size) const {
+        records.push_back("text:" + std::string(payload, size));
+    }
+};
+
+std::size_t decode(const char *data, std::size_t size, std::vector<std::string> &records) {
+    return decode_batch<Text, Quote>(data, size, Describe{records});
+}
+
+TEST(test_batch_encoder, encode) {
+    const Text hello{"hello"};
+    const Quote quote{7, 1.5};
+    const Text empty{""};
+
+    Encoder encoder;
+
+    encoder.add(hello);
+    encoder.add(quote);
+    encoder.add(empty);
+
+    ASSERT_EQ(3u, encoder.count());
+    ASSERT_EQ(3 * sizeof(batch_header) + 5 + sizeof(Quote), encoder.size());
+
+    std::string buffer("x");
+
+    encoder.encode_to(buffer);
+    ASSERT_EQ(1 + encoder.size(), buffer.size());
+
+    batch_header header;
+
+    std::memcpy(&header, &buffer[1], sizeof(header));
+    ASSERT_EQ(0u, header.tag);
+    ASSERT_EQ(5u, header.size);
+
+    std::vector<std::string> records;
+
+    ASSERT_EQ(encoder.size(), decode(buffer.data() + 1, buffer.size() - 1, records));
+    ASSERT_EQ((std::vector<std::string>{"text:hello", "quote:7", "text:"}), records);
+}
+
+TEST(test_batch_encoder, partial_records) {
+    const Quote quote{1, 2.0};
+    const Text text{"abc"};
+
+    Encoder encoder;
+
+    encoder.add(quote);
+    encoder.add(text);
+
+    std::vector<char> buffer;
+
+    encoder.encode_to(buffer);
+
+    const std::size_t first = sizeof(batch_header) + sizeof(Quote);
+
+    for (std::size_t n = first; n < buffer.size(); ++n) {
+        std::vector<std::string> records;
+
+        ASSERT_EQ(first, decode(buffer.data(), n, records));
+        ASSERT_EQ(1u, records.size());
+    }
+
+    std::vector<std::string> records;
+
+    ASSERT_EQ(0u, decode(buffer.data(), first - 1, records));
+    ASSERT_TRUE(records.empty());
+
+    encoder.clear();
+    ASSERT_EQ(0u, encoder.count());
+    ASSERT_EQ(0u, encoder.size());
+}
+
+struct Buffer {
+    void *iov_base;
+    std::size_t iov_len;
+};
+
+TEST(test_batch_encoder, gather) {
+    const Text a{"a"};
+    const Quote q0{1, 1.0};
+    const Quote q1{2, 2.0};
+    const Text bc{"bc"};
+
+    Encoder encoder;
+
+    encoder.add(a);
+    encoder.add(q0);
+    encoder.add(q1);
+    encoder.add(bc);
+
+    ASSERT_EQ(4 * sizeof(batch_header) + 3, encoder.scratch_size());
+
+    std::vector<char> scratch(encoder.scratch_size());
+    std::vector<Buffer> buffers(encoder.max_buffers());
+
+    const std::size_t n = encoder.gather(buffers.data(), scratch.data());
+
+    // The quotes are not copied, and the scratch space in between them holds the next header.
+    ASSERT_EQ(5u, n);
+    ASSERT_EQ(&q0, buffers[1].iov_base);
+    ASSERT_EQ(sizeof(batch_header), buffers[2].iov_len);
+    ASSERT_EQ(&q1, buffers[3].iov_base);
+
+    std::string gathered;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        gathered.append(static_cast<const char *>(buffers[i].iov_base), buffers[i].iov_len);
+    }
+
+    std::string encoded;
+
+    encoder.encode_to(encoded);
+    ASSERT_EQ(encoded, gathered);
+}
+
+} // namespace integral_switch
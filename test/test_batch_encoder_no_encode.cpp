@@ -0,0 +1,45 @@
+/*
+ * test_batch_encoder.cpp
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// Must not compile: a message with encoded_size() but without encode() would otherwise be sized by
+// encoded_size() and written as its bytes. test/CMakeLists.txt expects the build to fail.
+
+#include <cstddef>
+#include <vector>
+
+#include "batch_encoder.h"
+
+namespace app {
+
+struct Big {
+    char bytes[64];
+};
+
+std::size_t encoded_size(const Big &) { return 4; }
+
+} // namespace app
+
+int main() {
+    const app::Big big{};
+    std::vector<char> buffer;
+
+    integral_switch::batch_encoder<app::Big> encoder;
+
+    encoder.add(big);
+    encoder.encode_to(buffer);
+    return 0;
+}
@@ -54,6 +54,122 @@ TEST(test_dispatch, dispatch) {
     ASSERT_EQ(-1, Switch::visit_nothrow(visitor, 3, -1));
 }
 
+TEST(test_dispatch, miss_policy) {
+    GetId visitor;
+    std::error_code ec;
+
+    ASSERT_EQ(2, Switch::visit<abort_on_miss>(visitor, 2));
+    ASSERT_DEATH(Switch::visit<abort_on_miss>(visitor, 3), "");
+    ASSERT_EQ(1, Switch::visit(visitor, 1, ec));
+    ASSERT_FALSE(ec);
+    ASSERT_EQ(0, Switch::visit(visitor, 3, ec));
+    ASSERT_EQ(std::errc::invalid_argument, ec);
+}
+
+struct Negate {
+    constexpr int operator()(std::size_t i) const { return -static_cast<int>(i); }
+};
+
+TEST(test_dispatch, visit_or) {
+    GetId visitor;
+
+    ASSERT_EQ(1, Switch::visit_or(visitor, 1, Negate{}));
+    ASSERT_EQ(-3, Switch::visit_or(visitor, 3, Negate{}));
+}
+
+struct Make {
+    template <typename T> T operator()(type<T>) const { return T{}; }
+};
+
+using Repeated = variadic_switch<Type0, Type1, Type0, Type2>;
+
+#ifdef USE_CPP_17_VARIANT
+TEST(test_dispatch, visit_variant) {
+    static_assert(std::is_same<std::variant<Type0, Type1, Type2>,
+                               Repeated::variant_return_type<Make>>::value,
+                  "repeated result types appear once");
+
+    ASSERT_EQ(1, Repeated::visit_variant(Make{}, 1).index());
+    ASSERT_EQ(0, Repeated::visit_variant(Make{}, 2).index());
+    ASSERT_EQ(2, Repeated::visit_variant(Make{}, 3).index());
+    ASSERT_THROW(Repeated::visit_variant(Make{}, 4), std::invalid_argument);
+}
+
+TEST(test_dispatch, visit_variant_convertible) {
+    // A Type0 converts to both alternatives, so only its position tells them apart.
+    using Qualified = variadic_switch<Type0, const Type0, Type1>;
+
+    static_assert(std::is_same<std::variant<Type0, const Type0, Type1>,
+                               Qualified::variant_return_type<Make>>::value,
+                  "cv-qualified result types are distinct alternatives");
+
+    ASSERT_EQ(0, Qualified::visit_variant(Make{}, 0).index());
+    ASSERT_EQ(1, Qualified::visit_variant(Make{}, 1).index());
+    ASSERT_EQ(2, Qualified::visit_variant(Make{}, 2).index());
+}
+#endif
+
+TEST(test_dispatch, visit_unchecked) {
+    GetId visitor;
+
+    ASSERT_EQ(0, Switch::visit_unchecked(visitor, 0));
+    ASSERT_EQ(2, Switch::visit_unchecked(visitor, 2));
+}
+
+TEST(test_dispatch, outline) {
+    GetId visitor;
+
+    ASSERT_EQ(0, Switch::visit(outline(visitor), 0));
+    ASSERT_EQ(2, Switch::visit(outline<type<Type2>>(visitor), 2));
+    ASSERT_THROW(Switch::visit(outline<type<Type2>>(visitor), 3), std::invalid_argument);
+    ASSERT_EQ(-1, Switch::visit_nothrow(outline<type<Type1>>(visitor), 3, -1));
+}
+
+struct Incomplete;
+
+template <std::size_t I> struct Tag {};
+
+template <typename> struct TagSwitch;
+
+template <std::size_t... Is> struct TagSwitch<detail::index_sequence<Is...>> {
+    using type = variadic_switch<Tag<Is>...>;
+};
+
+TEST(test_dispatch, type_lookup) {
+    using Mixed = variadic_switch<Type0, Incomplete, const Type1 &, Type2>;
+
+    static_assert(std::is_same<Type0, Mixed::type_at<0>>::value, "");
+    static_assert(std::is_same<Incomplete, Mixed::type_at<1>>::value, "");
+    static_assert(std::is_same<const Type1 &, Mixed::type_at<2>>::value, "");
+    static_assert(0 == Mixed::index_of<Type0>(), "");
+    static_assert(1 == Mixed::index_of<Incomplete>(), "");
+    static_assert(2 == Mixed::index_of<const Type1 &>(), "");
+    static_assert(3 == Mixed::index_of<Type2>(), "");
+
+    // Repeated types can be looked up by position.
+    static_assert(std::is_same<Type0, Repeated::type_at<2>>::value, "");
+    static_assert(3 == Repeated::index_of<Type2>(), "");
+
+    using Large = TagSwitch<detail::make_index_sequence<500>>::type;
+
+    static_assert(std::is_same<Tag<499>, Large::type_at<499>>::value, "");
+    static_assert(321 == Large::index_of<Tag<321>>(), "");
+
+    ASSERT_EQ(2, Switch::visit(GetId{}, Switch::index_of<Type2>()));
+}
+
+struct IdPlus {
+    template <typename T> int operator()(type<T>, int x) const { return T{}.id() + x; }
+};
+
+TEST(test_dispatch, resolve) {
+    int (*id_plus)(int) = Switch::resolve<int(int), IdPlus>(2);
+
+    ASSERT_EQ(12, id_plus(10));
+    ASSERT_EQ(10, (Switch::resolve<int(int), IdPlus>(0)(10)));
+    ASSERT_THROW((Switch::resolve<int(int), IdPlus>(3)), std::invalid_argument);
+}
+
 #ifdef USE_CPP_14_CONSTEXPR
 
 TEST(test_dispatch, staticassert) {
@@ -63,6 +179,8 @@ TEST(test_dispatch, staticassert) {
     static_assert(1 == Switch::visit_nothrow(visitor, 1, -1), "");
     static_assert(2 == Switch::visit_nothrow(visitor, 2, -1), "");
     static_assert(-1 == Switch::visit_nothrow(visitor, 3, -1), "");
+    static_assert(1 == Switch::visit_unchecked(visitor, 1), "");
+    static_assert(-4 == Switch::visit_or(visitor, 4, Negate{}), "");
 }
 
 #endif
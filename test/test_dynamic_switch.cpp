@@ -0,0 +1,136 @@
+/*
+ * test_dynamic_switch.cpp
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "dynamic_switch.h"
+
+namespace integral_switch {
+
+using switch_ = dynamic_switch<int(int), int, 7, 3, 40, 0, 65, 12>;
+
+TEST(test_dynamic_switch, bind) {
+    switch_ s;
+
+    s.bind<7>([](int x) { return x + 7; });
+    ASSERT_TRUE(s.bind(40, [](int x) { return x * 40; }));
+    ASSERT_FALSE(s.bind(41, [](int x) { return x; }));
+
+    ASSERT_EQ(9, s.visit(7, 2));
+    ASSERT_EQ(80, s.visit(40, 2));
+    ASSERT_TRUE(s.bound(7));
+    ASSERT_FALSE(s.bound(3));
+    ASSERT_FALSE(s.bound(41));
+}
+
+TEST(test_dynamic_switch, miss) {
+    switch_ s;
+
+    s.bind<3>([](int x) { return x; });
+    ASSERT_THROW(s.visit(12, 1), std::invalid_argument);
+    ASSERT_THROW(s.visit(13, 1), std::invalid_argument);
+
+    s.unbind(3);
+    ASSERT_FALSE(s.bound(3));
+    ASSERT_THROW(s.visit(3, 1), std::invalid_argument);
+}
+
+TEST(test_dynamic_switch, rebind) {
+    switch_ s;
+    int calls = 0;
+
+    s.bind<0>([&calls](int x) { return calls += x; });
+    s.visit(0, 1);
+    s.bind(0, [&calls](int x) { return calls -= x; });
+    s.visit(0, 3);
+    ASSERT_EQ(-2, calls);
+}
+
+struct ThrowingCopy {
+    ThrowingCopy() = default;
+    ThrowingCopy(const ThrowingCopy &) { throw std::runtime_error("copy"); }
+
+    int operator()(int x) const { return x; }
+};
+
+TEST(test_dynamic_switch, rebind_throws) {
+    switch_ s;
+    const ThrowingCopy handler;
+
+    s.bind<0>([](int x) { return x + 1; });
+    ASSERT_THROW(s.bind<0>(handler), std::runtime_error);
+    ASSERT_FALSE(s.bound(0));
+    ASSERT_THROW(s.visit(0, 1), std::invalid_argument);
+
+    s.bind<0>([](int x) { return x + 2; });
+    ASSERT_EQ(3, s.visit(0, 1));
+}
+
+TEST(test_dynamic_switch, lifetime) {
+    auto counter = std::make_shared<int>(0);
+
+    {
+        dynamic_switch<void(), int, 1, 2> s;
+
+        s.bind<1>([counter]() { ++*counter; });
+        s.bind<2>([counter]() { ++*counter; });
+        ASSERT_EQ(3, counter.use_count());
+
+        s.bind<2>([]() {});
+        ASSERT_EQ(2, counter.use_count());
+
+        s.visit(1);
+        ASSERT_EQ(1, *counter);
+    }
+
+    ASSERT_EQ(1, counter.use_count());
+}
+
+TEST(test_dynamic_switch, arguments) {
+    dynamic_switch<std::string(const std::string &, std::string &&), char, 'a', 'b'> s;
+
+    s.bind<'a'>([](const std::string &x, std::string &&y) { return x + y; });
+    s.bind<'b'>([](const std::string &x, std::string &&y) { return std::move(y) + x; });
+
+    ASSERT_EQ("xy", s.visit('a', "x", "y"));
+    ASSERT_EQ("yx", s.visit('b', "x", "y"));
+}
+
+template <typename> struct MakeSwitch;
+
+template <std::size_t... Is> struct MakeSwitch<detail::index_sequence<Is...>> {
+    using type = dynamic_switch<std::size_t(), std::size_t, (2 * Is)...>;
+};
+
+TEST(test_dynamic_switch, large) {
+    MakeSwitch<detail::make_index_sequence<300>>::type s;
+
+    s.bind<0>([]() { return std::size_t(1); });
+    ASSERT_TRUE(s.bind(598, []() { return std::size_t(2); }));
+    ASSERT_FALSE(s.bind(599, []() { return std::size_t(3); }));
+
+    ASSERT_EQ(1, s.visit(0));
+    ASSERT_EQ(2, s.visit(598));
+    ASSERT_THROW(s.visit(2), std::invalid_argument);
+    ASSERT_THROW(s.visit(599), std::invalid_argument);
+}
+
+} // namespace integral_switch
@@ -0,0 +1,93 @@
+/*
+ * test_enum_switch.cpp
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "enum_switch.h"
+
+#ifdef USE_CPP_17_ENUM_NAMES
+
+namespace integral_switch {
+
+enum class Side : std::uint8_t { buy = 1, sell = 2, short_sell = 5 };
+
+enum Level { trace = -2, debug, info = 10, warn, error = 300 };
+
+enum class Wide : long long { low = -1000, high = 1000, mid = 0 };
+
+template <> struct enum_range<Wide> {
+    static constexpr long long min = -1000;
+    static constexpr long long max = 1000;
+};
+
+struct Visitor {
+    template <typename E, E V> int operator()(std::integral_constant<E, V>) const {
+        return static_cast<int>(V);
+    }
+};
+
+TEST(test_enum_switch, discovery) {
+    static_assert(enum_count<Side>() == 3, "");
+    static_assert(enum_values<Side>()[2] == Side::short_sell, "");
+    static_assert(enum_count<Level>() == 5, "");
+    static_assert(enum_values<Level>()[0] == trace, "");
+    static_assert(enum_values<Level>()[4] == error, "");
+    static_assert(enum_count<Wide>() == 3, "");
+    static_assert(enum_values<Wide>()[1] == Wide::mid, "");
+
+    ASSERT_TRUE((std::is_same<enum_switch<Side>,
+                              integral_switch<Side, Side::buy, Side::sell, Side::short_sell>>::value));
+}
+
+TEST(test_enum_switch, visit) {
+    ASSERT_EQ(5, enum_switch<Side>::visit(Visitor{}, Side::short_sell));
+    ASSERT_EQ(300, enum_switch<Level>::visit(Visitor{}, error));
+    ASSERT_EQ(-1, enum_switch<Level>::visit(Visitor{}, debug));
+    ASSERT_THROW(enum_switch<Side>::visit(Visitor{}, static_cast<Side>(3)), std::invalid_argument);
+}
+
+TEST(test_enum_switch, to_string) {
+    static_assert(to_string(Side::sell) == "sell", "");
+
+    ASSERT_EQ("short_sell", to_string(Side::short_sell));
+    ASSERT_EQ("", to_string(static_cast<Side>(0)));
+    ASSERT_EQ("", to_string(static_cast<Side>(255)));
+    ASSERT_EQ("trace", to_string(trace));
+    ASSERT_EQ("warn", to_string(warn));
+    ASSERT_EQ("error", to_string(error));
+    ASSERT_EQ("", to_string(static_cast<Level>(-3)));
+    ASSERT_EQ("", to_string(static_cast<Level>(100000)));
+    ASSERT_EQ("low", to_string(Wide::low));
+}
+
+TEST(test_enum_switch, from_string) {
+    ASSERT_EQ(Side::buy, from_string<Side>("buy"));
+    ASSERT_EQ(Side::short_sell, from_string<Side>("short_sell"));
+    ASSERT_FALSE(from_string<Side>("short"));
+    ASSERT_FALSE(from_string<Side>(""));
+    ASSERT_EQ(info, from_string<Level>("info"));
+    ASSERT_EQ(Wide::high, from_string<Wide>("high"));
+
+    for (const auto level : enum_values<Level>()) {
+        ASSERT_EQ(level, from_string<Level>(to_string(level)));
+    }
+}
+
+} // namespace integral_switch
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * test_fold_switch.cpp
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define INTEGRAL_SWITCH_FOLD_BACKEND
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+#include <type_traits>
+
+#include "integral_switch.h"
+
+namespace integral_switch {
+
+#ifdef USE_CPP_17_FOLD_BACKEND
+
+template <std::size_t I> using size_constant = std::integral_constant<std::size_t, I>;
+
+struct Visitor {
+    template <std::size_t I> constexpr std::size_t operator()(size_constant<I>) const { return I; }
+};
+
+using switch_ = integral_switch<std::size_t, 7, 3, 40, 0, 65, 12>;
+
+static_assert(std::is_same<detail::switch_impl_t<std::size_t, 7, 3, 40, 0, 65, 12>,
+                           detail::fold_switch_impl<std::size_t, 7, 3, 40, 0, 65, 12>>::value,
+              "the fold backend replaces the generated switch statements");
+
+TEST(test_fold_switch, visit) {
+    Visitor visitor;
+
+    ASSERT_EQ(7, switch_::visit(visitor, 7));
+    ASSERT_EQ(0, switch_::visit(visitor, 0));
+    ASSERT_EQ(12, switch_::visit(visitor, 12));
+    ASSERT_THROW(switch_::visit(visitor, 1), std::invalid_argument);
+
+    ASSERT_EQ(65, switch_::visit_nothrow(visitor, 65, -1));
+    ASSERT_EQ(-1, switch_::visit_nothrow(visitor, 66, -1));
+}
+
+struct CountVisitor {
+    std::size_t &count;
+
+    template <std::size_t I> void operator()(size_constant<I>) const { count += I; }
+};
+
+TEST(test_fold_switch, void_return) {
+    std::size_t count = 0;
+    CountVisitor visitor{count};
+
+    switch_::visit(visitor, 40);
+    switch_::visit(visitor, 3);
+    ASSERT_EQ(43, count);
+    ASSERT_THROW(switch_::visit(visitor, 4), std::invalid_argument);
+}
+
+struct NoDefault {
+    explicit NoDefault(std::size_t v) : value(v) {}
+
+    std::size_t value;
+};
+
+struct NoDefaultVisitor {
+    template <std::size_t I> NoDefault operator()(size_constant<I>) const { return NoDefault{I}; }
+};
+
+struct RefVisitor {
+    std::size_t (&values)[66];
+
+    template <std::size_t I> std::size_t &operator()(size_constant<I>) const { return values[I]; }
+};
+
+TEST(test_fold_switch, non_assignable_return) {
+    NoDefaultVisitor visitor;
+
+    ASSERT_EQ(40, switch_::visit(visitor, 40).value);
+    ASSERT_THROW(switch_::visit(visitor, 41), std::invalid_argument);
+
+    std::size_t values[66] = {};
+    RefVisitor ref_visitor{values};
+
+    switch_::visit(ref_visitor, 65) = 1;
+    ASSERT_EQ(1, values[65]);
+    ASSERT_EQ(&values[12], &switch_::visit(ref_visitor, 12));
+}
+
+struct StringVisitor {
+    template <std::size_t I> std::string operator()(size_constant<I>) const {
+        return std::string(I, 'x');
+    }
+};
+
+TEST(test_fold_switch, non_trivial_return) {
+    // Returned through the thunk_table rather than assigned to a local std::string in every case.
+    StringVisitor visitor;
+
+    ASSERT_EQ(std::string(40, 'x'), switch_::visit(visitor, 40));
+    ASSERT_EQ(std::string(), switch_::visit(visitor, 0));
+    ASSERT_EQ("none", switch_::visit_nothrow(visitor, 41, std::string("none")));
+}
+
+struct ByteVisitor {
+    template <std::uint8_t I>
+    constexpr int operator()(std::integral_constant<std::uint8_t, I>) const {
+        return I;
+    }
+};
+
+TEST(test_fold_switch, values_wider_than_keys) {
+    using byte_switch = integral_switch<std::uint8_t, 1, 2, 3>;
+    ByteVisitor visitor;
+
+    ASSERT_EQ(1, byte_switch::visit(visitor, 1));
+    ASSERT_EQ(-1, byte_switch::visit_nothrow(visitor, 257, -1));
+    ASSERT_EQ(-1, byte_switch::visit_nothrow(visitor, -255, -1));
+    ASSERT_THROW(byte_switch::visit(visitor, 258), std::invalid_argument);
+}
+
+TEST(test_fold_switch, staticassert) {
+    Visitor visitor;
+    static_assert(switch_::visit_nothrow(visitor, 7, -1) == 7, "");
+    static_assert(switch_::visit_nothrow(visitor, 65, -1) == 65, "");
+    static_assert(switch_::visit_nothrow(visitor, 66, -1) == static_cast<std::size_t>(-1), "");
+}
+
+#endif
+
+} // namespace integral_switch
@@ -0,0 +1,223 @@
+/*
+ * test_kernel_switch.cpp
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <limits>
+#include <vector>
+
+#include "kernel_switch.h"
+
+namespace integral_switch {
+
+// Longer than a chunk of the generic path, and not a multiple of it.
+constexpr std::size_t length = 3 * INTEGRAL_SWITCH_KERNEL_CHUNK + 17;
+
+template <typename T> std::vector<T> iota(T first) {
+    std::vector<T> values;
+
+    for (std::size_t i = 0; i < length; ++i) {
+        values.push_back(static_cast<T>(first + static_cast<T>(i % 100)));
+    }
+    return values;
+}
+
+TEST(test_kernel_switch, add) {
+    const auto a = iota<std::int32_t>(-50);
+    const auto b = iota<std::int32_t>(7);
+
+    std::vector<std::int32_t> sum(length);
+    std::vector<double> generic(length);
+
+    ASSERT_TRUE(kernel_switch<add_kernel>::specialised(dtype::int32, dtype::int32));
+    ASSERT_FALSE(kernel_switch<add_kernel>::specialised(dtype::int32, dtype::float64));
+
+    kernel_switch<add_kernel>::run(dtype::int32, dtype::int32, a.data(), b.data(), sum.data(),
+                                   length);
+    kernel_switch<add_kernel>::run(dtype::int32, dtype::float64, a.data(), b.data(),
+                                   generic.data(), length);
+
+    for (std::size_t i = 0; i < length; ++i) {
+        ASSERT_EQ(a[i] + b[i], sum[i]);
+        ASSERT_EQ(static_cast<double>(a[i] + b[i]), generic[i]);
+    }
+
+    // In place.
+    std::vector<std::int32_t> c = a;
+
+    kernel_switch<add_kernel>::run(dtype::int32, dtype::int32, c.data(), b.data(), c.data(),
+                                   length);
+    ASSERT_EQ(sum, c);
+}
+
+TEST(test_kernel_switch, wide_integers) {
+    const std::int64_t big = std::int64_t(1) << 60;
+    const std::vector<std::int64_t> a = {big + 1, std::numeric_limits<std::int64_t>::max(),
+                                         std::int64_t(1) << 53};
+    const std::vector<std::int64_t> b = {0, 1, (std::int64_t(1) << 53) + 1};
+
+    std::vector<std::uint64_t> sum(a.size());
+    std::vector<std::int64_t> wrapped(a.size());
+    std::vector<std::uint8_t> mask(a.size());
+    std::vector<std::int64_t> generic_mask(a.size());
+
+    kernel_switch<add_kernel>::run(dtype::int64, dtype::uint64, a.data(), b.data(), sum.data(),
+                                   a.size());
+    kernel_switch<add_kernel>::run(dtype::int64, dtype::int64, a.data(), b.data(),
+                                   wrapped.data(), a.size());
+    kernel_switch<less_kernel>::run(dtype::int64, dtype::uint8, a.data(), b.data(), mask.data(),
+                                    a.size());
+    kernel_switch<less_kernel>::run(dtype::int64, dtype::int64, a.data(), b.data(),
+                                    generic_mask.data(), a.size());
+
+    ASSERT_EQ(static_cast<std::uint64_t>(big) + 1, sum[0]);
+    ASSERT_EQ(std::numeric_limits<std::int64_t>::min(), wrapped[1]);
+    ASSERT_EQ(1, mask[2]);
+    ASSERT_EQ(1, generic_mask[2]);
+
+    std::int64_t total = 0;
+
+    kernel_switch<sum_kernel>::run(dtype::int64, dtype::int64, a.data(), nullptr, &total, 2);
+    ASSERT_EQ(std::numeric_limits<std::int64_t>::min() + big, total);
+}
+
+TEST(test_kernel_switch, narrowing_outputs) {
+    const std::vector<std::int32_t> a = {std::numeric_limits<std::int32_t>::max(), -40000, 3};
+    const std::vector<std::int32_t> b = {1, -40000, 4};
+
+    std::vector<std::int16_t> sum(a.size());
+
+    ASSERT_FALSE(kernel_switch<add_kernel>::specialised(dtype::int32, dtype::int16));
+
+    kernel_switch<add_kernel>::run(dtype::int32, dtype::int16, a.data(), b.data(), sum.data(),
+                                   a.size());
+
+    ASSERT_EQ(0, sum[0]);
+    ASSERT_EQ(static_cast<std::int16_t>(-80000), sum[1]);
+    ASSERT_EQ(7, sum[2]);
+
+    // Floating point results saturate in integer outputs.
+    const std::vector<double> x = {1e300, -1e300, std::numeric_limits<double>::quiet_NaN(), 2.5};
+    const std::vector<double> y(x.size(), 0.0);
+
+    std::vector<std::int32_t> saturated(x.size());
+
+    kernel_switch<add_kernel>::run(dtype::float64, dtype::int32, x.data(), y.data(),
+                                   saturated.data(), x.size());
+
+    ASSERT_EQ(std::numeric_limits<std::int32_t>::max(), saturated[0]);
+    ASSERT_EQ(std::numeric_limits<std::int32_t>::min(), saturated[1]);
+    ASSERT_EQ(0, saturated[2]);
+    ASSERT_EQ(2, saturated[3]);
+}
+
+TEST(test_kernel_switch, cast) {
+    const auto a = iota<std::int16_t>(-50);
+
+    std::vector<float> floats(length);
+
+    auto cast = kernel_switch<cast_kernel>::resolve(dtype_of<std::int16_t>::value,
+                                                    dtype_of<float>::value);
+
+    cast(a.data(), nullptr, floats.data(), length);
+
+    for (std::size_t i = 0; i < length; ++i) {
+        ASSERT_EQ(static_cast<float>(a[i]), floats[i]);
+    }
+}
+
+TEST(test_kernel_switch, saturating_cast) {
+    const std::vector<double> a = {1e20, -1e20, std::numeric_limits<double>::quiet_NaN(), -2.5};
+
+    std::vector<std::int32_t> ints(a.size());
+
+    ASSERT_TRUE(kernel_switch<cast_kernel>::specialised(dtype::float64, dtype::int32));
+
+    kernel_switch<cast_kernel>::run(dtype::float64, dtype::int32, a.data(), nullptr, ints.data(),
+                                    a.size());
+
+    ASSERT_EQ(std::numeric_limits<std::int32_t>::max(), ints[0]);
+    ASSERT_EQ(std::numeric_limits<std::int32_t>::min(), ints[1]);
+    ASSERT_EQ(0, ints[2]);
+    ASSERT_EQ(-2, ints[3]);
+
+    const std::vector<float> f = {1e30f, -1e30f, std::numeric_limits<float>::quiet_NaN()};
+
+    std::vector<std::uint8_t> bytes(f.size());
+
+    kernel_switch<cast_kernel>::run(dtype::float32, dtype::uint8, f.data(), nullptr, bytes.data(),
+                                    f.size());
+
+    ASSERT_EQ(255, bytes[0]);
+    ASSERT_EQ(0, bytes[1]);
+    ASSERT_EQ(0, bytes[2]);
+}
+
+TEST(test_kernel_switch, less) {
+    const auto a = iota<float>(0.0f);
+    const std::vector<float> b(length, 49.5f);
+
+    std::vector<std::uint8_t> mask(length);
+    std::vector<std::int64_t> generic(length);
+
+    kernel_switch<less_kernel>::run(dtype::float32, dtype::uint8, a.data(), b.data(),
+                                    mask.data(), length);
+    kernel_switch<less_kernel>::run(dtype::float32, dtype::int64, a.data(), b.data(),
+                                    generic.data(), length);
+
+    for (std::size_t i = 0; i < length; ++i) {
+        ASSERT_EQ(a[i] < 49.5f ? 1 : 0, mask[i]);
+        ASSERT_EQ(a[i] < 49.5f ? 1 : 0, generic[i]);
+    }
+}
+
+TEST(test_kernel_switch, sum) {
+    const auto a = iota<std::uint8_t>(100);
+
+    std::int64_t expected = 0;
+
+    for (const auto x : a) {
+        expected += x;
+    }
+
+    std::uint64_t wide = 0;
+    std::uint8_t narrow = 0;
+    float generic = 0;
+
+    ASSERT_TRUE(kernel_switch<sum_kernel>::specialised(dtype::uint8, dtype::uint64));
+    ASSERT_FALSE(kernel_switch<sum_kernel>::specialised(dtype::uint8, dtype::int64));
+
+    kernel_switch<sum_kernel>::run(dtype::uint8, dtype::uint64, a.data(), nullptr, &wide, length);
+    kernel_switch<sum_kernel>::run(dtype::uint8, dtype::uint8, a.data(), nullptr, &narrow, length);
+    kernel_switch<sum_kernel>::run(dtype::uint8, dtype::float32, a.data(), nullptr, &generic,
+                                   length);
+
+    ASSERT_EQ(static_cast<std::uint64_t>(expected), wide);
+    ASSERT_EQ(static_cast<std::uint8_t>(expected), narrow);
+    ASSERT_EQ(static_cast<float>(expected), generic);
+}
+
+TEST(test_kernel_switch, invalid_dtype) {
+    ASSERT_THROW(kernel_switch<cast_kernel>::resolve(static_cast<dtype>(10), dtype::int8),
+                 std::invalid_argument);
+    ASSERT_THROW(kernel_switch<cast_kernel>::resolve(dtype::int8, static_cast<dtype>(10)),
+                 std::invalid_argument);
+    ASSERT_FALSE(kernel_switch<cast_kernel>::specialised(dtype::int8, static_cast<dtype>(10)));
+}
+
+} // namespace integral_switch
@@ -0,0 +1,167 @@
+/*
+ * test_mpsc_queue.cpp
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mpsc_queue.h"
+
+namespace integral_switch {
+
+struct Add {
+    int value;
+};
+
+struct Name {
+    std::string value;
+};
+
+struct Owned {
+    std::unique_ptr<int> value;
+};
+
+using queue_ = mpsc_queue<1024, Add, Name, Owned>;
+
+struct Collect {
+    int sum;
+    std::string names;
+
+    void operator()(const Add &m) { sum += m.value; }
+    void operator()(const Name &m) { names += m.value; }
+    void operator()(const Owned &m) { sum += *m.value; }
+};
+
+TEST(test_mpsc_queue, consume) {
+    queue_ q;
+    Collect c{0, ""};
+
+    ASSERT_TRUE(q.try_emplace<Add>(Add{1}));
+    ASSERT_TRUE(q.try_push(Name{"a"}));
+    ASSERT_TRUE(q.try_emplace<Owned>(Owned{std::unique_ptr<int>(new int(10))}));
+    ASSERT_TRUE(q.try_push(Name{"b"}));
+
+    ASSERT_EQ(2, q.consume(c, 2));
+    ASSERT_EQ(1, c.sum);
+    ASSERT_EQ("a", c.names);
+
+    ASSERT_EQ(2, q.consume(c));
+    ASSERT_EQ(11, c.sum);
+    ASSERT_EQ("ab", c.names);
+    ASSERT_EQ(0, q.consume(c));
+}
+
+TEST(test_mpsc_queue, full) {
+    mpsc_queue<128, Add> q;
+    Collect c{0, ""};
+
+    // Every record takes a header and a payload unit of 16 bytes.
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(q.try_push(Add{i}));
+    }
+    ASSERT_FALSE(q.try_push(Add{4}));
+
+    ASSERT_EQ(4, q.consume(c));
+    ASSERT_EQ(6, c.sum);
+    ASSERT_TRUE(q.try_push(Add{4}));
+}
+
+struct Big {
+    char data[40];
+};
+
+TEST(test_mpsc_queue, wrap_around) {
+    mpsc_queue<128, Add, Big> q;
+    int sum = 0;
+    int bigs = 0;
+
+    struct Visitor {
+        int &sum;
+        int &bigs;
+
+        void operator()(const Add &m) const { sum += m.value; }
+        void operator()(const Big &) const { ++bigs; }
+    } visitor{sum, bigs};
+
+    // The buffer has 8 units and Add takes 2 of them. Big takes 4 units, so after three Adds it is
+    // preceded by 2 units of padding up to the end of the buffer and starts at the beginning.
+    ASSERT_TRUE(q.try_push(Add{1}));
+    ASSERT_TRUE(q.try_push(Add{2}));
+    ASSERT_TRUE(q.try_push(Add{3}));
+    ASSERT_EQ(3, q.consume(visitor));
+
+    ASSERT_TRUE(q.try_push(Big{}));
+    ASSERT_FALSE(q.try_push(Big{}));
+    ASSERT_EQ(1, q.consume(visitor));
+    ASSERT_TRUE(q.try_push(Big{}));
+    ASSERT_TRUE(q.try_push(Big{}));
+    ASSERT_EQ(2, q.consume(visitor));
+    ASSERT_EQ(6, sum);
+    ASSERT_EQ(3, bigs);
+}
+
+TEST(test_mpsc_queue, destroys_pending) {
+    auto value = std::make_shared<int>(0);
+
+    {
+        mpsc_queue<256, std::shared_ptr<int>> q;
+
+        ASSERT_TRUE(q.try_push(value));
+        ASSERT_EQ(2, value.use_count());
+    }
+
+    ASSERT_EQ(1, value.use_count());
+}
+
+TEST(test_mpsc_queue, producers) {
+    mpsc_queue<4096, Add, Name> q;
+    const int producers = 3;
+    const int messages = 20000;
+
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&]() {
+            for (int i = 1; i <= messages; ++i) {
+                while (!q.try_push(Add{i})) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    Collect c{0, ""};
+    long long sum = 0;
+    int received = 0;
+
+    while (received < producers * messages) {
+        c.sum = 0;
+        received += static_cast<int>(q.consume(c, 64));
+        sum += c.sum;
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(static_cast<long long>(producers) * messages * (messages + 1) / 2, sum);
+}
+
+} // namespace integral_switch
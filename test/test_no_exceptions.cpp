@@ -0,0 +1,63 @@
+/*
+ * test_no_exceptions.cpp
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <type_traits>
+
+#include "integral_switch.h"
+
+// Built with -fno-exceptions where the compiler supports it.
+namespace integral_switch {
+
+template <std::size_t I> using size_constant = std::integral_constant<std::size_t, I>;
+
+struct Visitor {
+    template <std::size_t I> constexpr std::size_t operator()(size_constant<I>) const { return I; }
+};
+
+using switch_ = integral_switch<std::size_t, 0, 1, 2, 3>;
+
+struct GetIndex {
+    template <typename T> std::size_t operator()(type<T>) const { return sizeof(T); }
+};
+
+using variadic_ = variadic_switch<char, int>;
+
+TEST(test_no_exceptions, visit) {
+    Visitor visitor;
+    std::error_code ec;
+
+    ASSERT_EQ(3, switch_::visit(visitor, 3));
+    ASSERT_EQ(2, switch_::visit(visitor, 2, ec));
+    ASSERT_EQ(-1, switch_::visit_nothrow(visitor, 4, -1));
+    ASSERT_EQ(0, switch_::visit(visitor, 4, ec));
+    ASSERT_EQ(std::errc::invalid_argument, ec);
+
+    ASSERT_EQ(sizeof(int), variadic_::visit(GetIndex{}, 1));
+}
+
+#ifndef USE_CPP_EXCEPTIONS
+TEST(test_no_exceptions, visit_aborts) {
+    Visitor visitor;
+
+    ASSERT_DEATH(switch_::visit(visitor, 4), "");
+    ASSERT_DEATH(variadic_::visit(GetIndex{}, 2), "");
+}
+#endif
+
+} // namespace integral_switch
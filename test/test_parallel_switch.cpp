@@ -0,0 +1,138 @@
+/*
+ * test_parallel_switch.cpp
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+#include "parallel_switch.h"
+
+namespace integral_switch {
+
+template <std::size_t I> using size_constant = std::integral_constant<std::size_t, I>;
+
+using switch_ = integral_switch<std::size_t, 0, 1, 2, 3>;
+
+struct Histogram {
+    std::size_t counts[4];
+
+    template <std::size_t I> void operator()(size_constant<I>, std::size_t) { ++counts[I]; }
+
+    void merge(const Histogram &other) {
+        for (std::size_t i = 0; i < 4; ++i) {
+            counts[i] += other.counts[i];
+        }
+    }
+};
+
+struct Order {
+    std::size_t side;
+    std::size_t quantity;
+};
+
+// Adds up the quantities of the orders per side, reading each order by the position of its key.
+struct Volume {
+    const std::vector<Order> *orders;
+    std::size_t totals[4];
+
+    template <std::size_t I> void operator()(size_constant<I>, std::size_t i) {
+        totals[I] += (*orders)[i].quantity;
+    }
+
+    void merge(const Volume &other) {
+        for (std::size_t i = 0; i < 4; ++i) {
+            totals[i] += other.totals[i];
+        }
+    }
+};
+
+TEST(test_parallel_switch, parallel_for) {
+    work_stealing_pool pool(4);
+    std::vector<std::atomic<int>> calls(1000);
+
+    ASSERT_EQ(4, pool.size());
+
+    for (int round = 0; round < 3; ++round) {
+        pool.parallel_for(calls.size(), [&](std::size_t worker, std::size_t task) {
+            ASSERT_LT(worker, pool.size());
+            ++calls[task];
+        });
+    }
+
+    for (const auto &c : calls) {
+        ASSERT_EQ(3, c.load());
+    }
+}
+
+TEST(test_parallel_switch, visit_batch_parallel) {
+    std::vector<std::size_t> keys;
+
+    for (std::size_t i = 0; i < 100000; ++i) {
+        keys.push_back(i * 7 % 4);
+    }
+
+    for (std::size_t threads : {1, 2, 5}) {
+        work_stealing_pool pool(threads);
+
+        const Histogram result =
+            visit_batch_parallel<switch_>(Histogram{}, keys.data(), keys.size(), pool, 1000);
+
+        ASSERT_EQ(25000, result.counts[0]);
+        ASSERT_EQ(25000, result.counts[1]);
+        ASSERT_EQ(25000, result.counts[2]);
+        ASSERT_EQ(25000, result.counts[3]);
+    }
+}
+
+TEST(test_parallel_switch, records) {
+    std::vector<Order> orders;
+    std::vector<std::size_t> sides;
+    std::size_t expected[4] = {};
+
+    for (std::size_t i = 0; i < 10000; ++i) {
+        orders.push_back(Order{i % 3, i});
+        sides.push_back(orders.back().side);
+        expected[i % 3] += i;
+    }
+
+    for (std::size_t threads : {1, 3}) {
+        work_stealing_pool pool(threads);
+
+        const Volume result = visit_batch_parallel<switch_>(Volume{&orders, {}}, sides.data(),
+                                                            sides.size(), pool, 100);
+
+        for (std::size_t side = 0; side < 4; ++side) {
+            ASSERT_EQ(expected[side], result.totals[side]);
+        }
+    }
+}
+
+TEST(test_parallel_switch, exception) {
+    work_stealing_pool pool(3);
+    const std::size_t keys[] = {0, 1, 4, 2};
+
+    ASSERT_THROW(visit_batch_parallel<switch_>(Histogram{}, keys, 4, pool, 1),
+                 std::invalid_argument);
+
+    // The pool can be used again.
+    const Histogram result = visit_batch_parallel<switch_>(Histogram{}, keys, 2, pool, 1);
+    ASSERT_EQ(1, result.counts[1]);
+}
+
+} // namespace integral_switch
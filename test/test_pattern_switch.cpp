@@ -0,0 +1,124 @@
+/*
+ * test_pattern_switch.cpp
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <gtest/gtest.h>
+
+#include "pattern_switch.h"
+
+#ifdef USE_CPP_14_CONSTEXPR
+
+namespace integral_switch {
+
+// A few RV32I encodings.
+using add = pattern<std::uint32_t, 0xfe00707f, 0x00000033>;
+using sub = pattern<std::uint32_t, 0xfe00707f, 0x40000033>;
+using addi = pattern<std::uint32_t, 0x0000707f, 0x00000013>;
+using lui = pattern<std::uint32_t, 0x0000007f, 0x00000037>;
+using jal = pattern<std::uint32_t, 0x0000007f, 0x0000006f>;
+using beq = pattern<std::uint32_t, 0x0000707f, 0x00000063>;
+using bne = pattern<std::uint32_t, 0x0000707f, 0x00001063>;
+
+using decoder = pattern_switch<add, sub, addi, lui, jal, beq, bne>;
+
+struct Mnemonic {
+    const char *operator()(add) const { return "add"; }
+    const char *operator()(sub) const { return "sub"; }
+    const char *operator()(addi) const { return "addi"; }
+    const char *operator()(lui) const { return "lui"; }
+    const char *operator()(jal) const { return "jal"; }
+    const char *operator()(beq) const { return "beq"; }
+    const char *operator()(bne) const { return "bne"; }
+};
+
+TEST(test_pattern_switch, decode) {
+    ASSERT_STREQ("add", decoder::visit(Mnemonic{}, 0x003100b3u));  // add x1, x2, x3
+    ASSERT_STREQ("sub", decoder::visit(Mnemonic{}, 0x403100b3u));  // sub x1, x2, x3
+    ASSERT_STREQ("addi", decoder::visit(Mnemonic{}, 0x00a00093u)); // addi x1, x0, 10
+    ASSERT_STREQ("lui", decoder::visit(Mnemonic{}, 0x123450b7u));  // lui x1, 0x12345
+    ASSERT_STREQ("jal", decoder::visit(Mnemonic{}, 0x008000efu));  // jal x1, 8
+    ASSERT_STREQ("beq", decoder::visit(Mnemonic{}, 0x00208463u));  // beq x1, x2, 8
+    ASSERT_STREQ("bne", decoder::visit(Mnemonic{}, 0x00209463u));  // bne x1, x2, 8
+
+    // Same opcode and funct3 as add, but funct7 of neither add nor sub.
+    ASSERT_THROW(decoder::visit(Mnemonic{}, 0x203100b3u), std::invalid_argument);
+    ASSERT_THROW(decoder::visit(Mnemonic{}, 0x00000000u), std::invalid_argument);
+    ASSERT_STREQ("none", decoder::visit_nothrow(Mnemonic{}, 0x7fu, "none"));
+
+    std::error_code ec;
+
+    ASSERT_EQ(nullptr, decoder::visit(Mnemonic{}, 0x7fu, ec));
+    ASSERT_TRUE(ec);
+}
+
+template <typename... Patterns> struct Index {
+    template <typename P> int operator()(P) const {
+        const bool found[] = {std::is_same<P, Patterns>::value...};
+
+        for (int i = 0; i < static_cast<int>(sizeof...(Patterns)); ++i) {
+            if (found[i]) {
+                return i;
+            }
+        }
+        return -1;
+    }
+};
+
+// The index of the only pattern that matches the value, or -1.
+template <typename... Patterns> int scan(std::uint8_t x) {
+    const bool matches[] = {Patterns::matches(x)...};
+    int index = -1;
+
+    for (int i = 0; i < static_cast<int>(sizeof...(Patterns)); ++i) {
+        if (matches[i]) {
+            EXPECT_EQ(-1, index);
+            index = i;
+        }
+    }
+    return index;
+}
+
+template <typename... Patterns> void check_all_values() {
+    using switch_type = pattern_switch<Patterns...>;
+
+    for (unsigned x = 0; x < 256; ++x) {
+        ASSERT_EQ(scan<Patterns...>(static_cast<std::uint8_t>(x)),
+                  switch_type::visit_nothrow(Index<Patterns...>{}, static_cast<std::uint8_t>(x),
+                                             -1))
+            << x;
+    }
+}
+
+template <std::uint8_t Mask, std::uint8_t Value> using byte = pattern<std::uint8_t, Mask, Value>;
+
+TEST(test_pattern_switch, dont_care_bits) {
+    // No bit is cared about by all patterns, so the tree splits on single bits.
+    check_all_values<byte<0x81, 0x80>, byte<0xc1, 0x41>, byte<0xce, 0x0a>, byte<0x4f, 0x05>,
+                     byte<0xff, 0x06>>();
+
+    // Flag words: a common field first, then single bits.
+    check_all_values<byte<0xf0, 0x10>, byte<0xf1, 0x21>, byte<0xf3, 0x22>, byte<0xf3, 0x30>,
+                     byte<0xff, 0x31>, byte<0xe0, 0xe0>>();
+
+    check_all_values<byte<0x00, 0x00>>();
+    check_all_values<byte<0xff, 0x2a>>();
+}
+
+} // namespace integral_switch
+
+#endif
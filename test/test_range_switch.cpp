@@ -0,0 +1,94 @@
+/*
+ * test_range_switch.cpp
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "range_switch.h"
+
+namespace integral_switch {
+
+struct Visitor {
+    template <std::size_t I> std::size_t operator()(std::integral_constant<std::size_t, I>) const {
+        return I;
+    }
+};
+
+using bands = range_switch<int, -10, 0, 10, 100>;
+
+TEST(test_range_switch, visit) {
+    ASSERT_EQ(3, bands::size);
+
+    ASSERT_EQ(0, bands::visit(Visitor{}, -10));
+    ASSERT_EQ(0, bands::visit(Visitor{}, -1));
+    ASSERT_EQ(1, bands::visit(Visitor{}, 0));
+    ASSERT_EQ(1, bands::visit(Visitor{}, 9));
+    ASSERT_EQ(2, bands::visit(Visitor{}, 10));
+    ASSERT_EQ(2, bands::visit(Visitor{}, 99));
+
+    ASSERT_THROW(bands::visit(Visitor{}, -11), std::invalid_argument);
+    ASSERT_THROW(bands::visit(Visitor{}, 100), std::invalid_argument);
+}
+
+TEST(test_range_switch, misses) {
+    ASSERT_EQ(7, bands::visit_nothrow(Visitor{}, 100, 7));
+    ASSERT_EQ(11, bands::visit_or(Visitor{}, -11, [](int v) { return std::size_t(-v); }));
+
+    std::error_code ec;
+
+    ASSERT_EQ(0, bands::visit(Visitor{}, 1000, ec));
+    ASSERT_TRUE(ec);
+    ASSERT_EQ(1, bands::visit(Visitor{}, 5, ec));
+    ASSERT_FALSE(ec);
+
+    ASSERT_EQ(3, bands::index_of(100));
+    ASSERT_EQ(3, bands::index_of(-100));
+    ASSERT_EQ(2, bands::index_of(50));
+}
+
+TEST(test_range_switch, character_classes) {
+    // Control characters, printable characters and the rest of the byte values.
+    using classes = range_switch<unsigned, 0, 32, 127, 256>;
+
+    ASSERT_EQ(0, classes::visit(Visitor{}, static_cast<unsigned char>('\t')));
+    ASSERT_EQ(1, classes::visit(Visitor{}, static_cast<unsigned char>('a')));
+    ASSERT_EQ(2, classes::visit(Visitor{}, static_cast<unsigned char>(200)));
+}
+
+template <std::size_t... Is>
+using squares = range_switch<std::size_t, Is * Is...>;
+
+TEST(test_range_switch, binary_search) {
+    // More bounds than INTEGRAL_SWITCH_RANGE_LINEAR are searched rather than scanned.
+    static_assert(71 > INTEGRAL_SWITCH_RANGE_LINEAR, "");
+    using large = squares<0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+                          20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37,
+                          38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55,
+                          56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70>;
+
+    for (std::size_t v = 0; v < 70 * 70; ++v) {
+        std::size_t i = 0;
+
+        while ((i + 1) * (i + 1) <= v) {
+            ++i;
+        }
+        ASSERT_EQ(i, large::visit(Visitor{}, v));
+    }
+    ASSERT_EQ(large::size, large::index_of(70 * 70));
+}
+
+} // namespace integral_switch
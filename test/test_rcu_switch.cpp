@@ -0,0 +1,130 @@
+/*
+ * test_rcu_switch.cpp
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "rcu_switch.h"
+
+namespace integral_switch {
+
+using switch_ = rcu_switch<int(int), int, 7, 3, 40, 0, 65, 12>;
+
+TEST(test_rcu_switch, bind) {
+    switch_ s;
+    auto reader = s.make_reader();
+
+    s.bind<7>([](int x) { return x + 7; });
+    ASSERT_TRUE(s.bind(40, [](int x) { return x * 40; }));
+    ASSERT_FALSE(s.bind(41, [](int x) { return x; }));
+
+    ASSERT_EQ(9, reader.visit(7, 2));
+    ASSERT_EQ(80, reader.visit(40, 2));
+    ASSERT_THROW(reader.visit(3, 2), std::invalid_argument);
+    ASSERT_THROW(reader.visit(41, 2), std::invalid_argument);
+
+    s.unbind(7);
+    ASSERT_FALSE(s.bound(7));
+    ASSERT_TRUE(s.bound(40));
+    ASSERT_THROW(reader.visit(7, 2), std::invalid_argument);
+}
+
+TEST(test_rcu_switch, deferred_reclamation) {
+    switch_ s;
+    auto counter = std::make_shared<int>(0);
+    auto reader = s.make_reader();
+
+    s.bind<0>([counter](int x) { return x; });
+    ASSERT_EQ(2, counter.use_count());
+
+    {
+        switch_::read_guard guard(reader);
+
+        ASSERT_EQ(1, reader.visit(0, 1));
+        s.bind<0>([](int x) { return -x; });
+        ASSERT_EQ(-1, reader.visit(0, 1));
+
+        // The reader may still use the replaced handler.
+        ASSERT_EQ(1, s.reclaim());
+        ASSERT_EQ(2, counter.use_count());
+    }
+
+    ASSERT_EQ(0, s.reclaim());
+    ASSERT_EQ(1, counter.use_count());
+}
+
+TEST(test_rcu_switch, readers) {
+    switch_ s;
+
+    {
+        auto r1 = s.make_reader();
+        auto r2 = std::move(r1);
+        std::vector<switch_::reader> readers;
+
+        for (int i = 1; i < INTEGRAL_SWITCH_MAX_READERS; ++i) {
+            readers.push_back(s.make_reader());
+        }
+        ASSERT_THROW(s.make_reader(), std::length_error);
+    }
+
+    auto reader = s.make_reader();
+}
+
+TEST(test_rcu_switch, concurrent_rebind) {
+    switch_ s;
+    std::atomic<bool> done{false};
+    std::atomic<int> errors{0};
+
+    s.bind<3>([](int x) { return x; });
+
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([&]() {
+            auto reader = s.make_reader();
+
+            while (!done.load()) {
+                const int r = reader.visit(3, 1);
+
+                if (r < 1 || r > 1000) {
+                    ++errors;
+                }
+            }
+        });
+    }
+
+    for (int i = 1; i <= 1000; ++i) {
+        auto value = std::make_shared<int>(i);
+
+        s.bind<3>([value](int x) { return x * *value; });
+    }
+
+    done.store(true);
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(0, errors.load());
+    ASSERT_EQ(0, s.reclaim());
+}
+
+} // namespace integral_switch
@@ -0,0 +1,98 @@
+/*
+ * test_sharded_dispatcher.cpp
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "sharded_dispatcher.h"
+
+namespace integral_switch {
+
+template <int I> struct Message {
+    std::uint64_t sequence;
+};
+
+struct Record {
+    std::vector<std::uint64_t> sequences[3];
+
+    template <int I> void operator()(const Message<I> &m) { sequences[I].push_back(m.sequence); }
+};
+
+using dispatcher_ = sharded_dispatcher<2, 4096, Record, Message<0>, Message<1>, Message<2>>;
+
+static_assert(dispatcher_::shard_of<Message<0>>() == 0, "");
+static_assert(dispatcher_::shard_of<Message<1>>() == 1, "");
+static_assert(dispatcher_::shard_of<Message<2>>() == 0, "");
+
+TEST(test_sharded_dispatcher, post) {
+    dispatcher_ dispatcher;
+    const std::uint64_t count = 10000;
+
+    for (std::uint64_t i = 0; i < count; ++i) {
+        dispatcher.post<Message<0>>(Message<0>{i});
+        dispatcher.post<Message<1>>(Message<1>{i});
+        dispatcher.post<Message<2>>(Message<2>{i});
+    }
+    dispatcher.stop();
+
+    // Every type is handled by one shard, in the order it was posted.
+    for (int type = 0; type < 3; ++type) {
+        const std::size_t shard = type == 1 ? 1 : 0;
+        const auto &sequences = dispatcher.handler(shard).sequences[type];
+
+        ASSERT_EQ(count, sequences.size());
+        ASSERT_TRUE(dispatcher.handler(1 - shard).sequences[type].empty());
+
+        for (std::uint64_t i = 0; i < count; ++i) {
+            ASSERT_EQ(i, sequences[i]);
+        }
+    }
+}
+
+TEST(test_sharded_dispatcher, post_keyed) {
+    dispatcher_ dispatcher(Record(), true);
+    const std::uint64_t count = 1000;
+
+    for (std::uint64_t i = 0; i < count; ++i) {
+        for (int key = 0; key < 4; ++key) {
+            dispatcher.post_keyed<Message<0>>(key, Message<0>{i * 4 + key});
+        }
+    }
+    dispatcher.stop();
+
+    std::size_t total = 0;
+
+    for (std::size_t shard = 0; shard < 2; ++shard) {
+        std::uint64_t last[4] = {};
+        bool seen[4] = {};
+
+        for (const auto s : dispatcher.handler(shard).sequences[0]) {
+            const int key = static_cast<int>(s % 4);
+
+            ASSERT_EQ(shard, dispatcher_::shard_of(key));
+            ASSERT_TRUE(!seen[key] || last[key] < s);
+            last[key] = s;
+            seen[key] = true;
+            ++total;
+        }
+    }
+    ASSERT_EQ(count * 4, total);
+}
+
+} // namespace integral_switch
@@ -0,0 +1,129 @@
+/*
+ * test_string_switch.cpp
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <string>
+
+#include "string_switch.h"
+
+namespace integral_switch {
+
+using new_order = string_key<'N', 'e', 'w', 'O', 'r', 'd', 'e', 'r'>;
+using cancel = string_key<'C', 'a', 'n', 'c', 'e', 'l'>;
+using replace = string_key<'R', 'e', 'p', 'l', 'a', 'c', 'e'>;
+using empty = string_key<>;
+
+using switch_ = basic_string_switch<new_order, cancel, replace, empty>;
+
+struct Visitor {
+    int operator()(new_order) const { return 1; }
+    int operator()(cancel) const { return 2; }
+    int operator()(replace) const { return 3; }
+    int operator()(empty) const { return 4; }
+};
+
+TEST(test_string_switch, visit) {
+    ASSERT_EQ(1, switch_::visit(Visitor{}, std::string("NewOrder")));
+    ASSERT_EQ(2, switch_::visit(Visitor{}, std::string("Cancel")));
+    ASSERT_EQ(3, switch_::visit(Visitor{}, std::string("Replace")));
+    ASSERT_EQ(4, switch_::visit(Visitor{}, std::string()));
+
+    ASSERT_THROW(switch_::visit(Visitor{}, std::string("Cancel ")), std::invalid_argument);
+    ASSERT_THROW(switch_::visit(Visitor{}, std::string("cancel")), std::invalid_argument);
+    ASSERT_THROW(switch_::visit(Visitor{}, std::string("New")), std::invalid_argument);
+}
+
+TEST(test_string_switch, misses) {
+    const std::string value("Amend");
+
+    ASSERT_EQ(0, switch_::visit_nothrow(Visitor{}, value, 0));
+    ASSERT_EQ(5, switch_::visit_or(Visitor{}, value, [](const std::string &s) {
+                  return static_cast<int>(s.size());
+              }));
+
+    std::error_code ec;
+
+    ASSERT_EQ(0, switch_::visit(Visitor{}, value, ec));
+    ASSERT_TRUE(ec);
+    ASSERT_EQ(2, switch_::visit(Visitor{}, std::string("Cancel"), ec));
+    ASSERT_FALSE(ec);
+}
+
+TEST(test_string_switch, find) {
+    ASSERT_EQ(0, switch_::find(std::string("NewOrder")));
+    ASSERT_EQ(2, switch_::find(std::string("Replace")));
+    ASSERT_EQ(3, switch_::find(std::string()));
+    ASSERT_EQ(4, switch_::find(std::string("Amend")));
+}
+
+struct KeyVisitor {
+    template <typename Key> std::string operator()(Key) const {
+        return std::string(Key::data, Key::size);
+    }
+};
+
+TEST(test_string_switch, keys) {
+    // The case of a key sees the key itself, including embedded zeros.
+    using zeros = basic_string_switch<string_key<'a', '\0'>, string_key<'a'>, string_key<'\0'>>;
+
+    ASSERT_EQ(std::string("a", 2), zeros::visit(KeyVisitor{}, std::string("a", 2)));
+    ASSERT_EQ(std::string("a"), zeros::visit(KeyVisitor{}, std::string("a")));
+    ASSERT_EQ(std::string("", 1), zeros::visit(KeyVisitor{}, std::string("", 1)));
+    ASSERT_THROW(zeros::visit(KeyVisitor{}, std::string("b")), std::invalid_argument);
+}
+
+// The I-th of the keys "aa", "ba", ..., "zz".
+template <std::size_t I>
+using letters = string_key<static_cast<char>('a' + I % 26), static_cast<char>('a' + I / 26)>;
+
+template <typename> struct letters_switch;
+
+template <std::size_t... Is> struct letters_switch<detail::index_sequence<Is...>> {
+    using type = basic_string_switch<letters<Is>...>;
+};
+
+TEST(test_string_switch, many_keys) {
+    // Enough keys that some buckets of the perfect hash hold several of them.
+    using many = letters_switch<detail::make_index_sequence<600>>::type;
+
+    for (std::size_t i = 0; i < 26 * 26; ++i) {
+        const char name[] = {static_cast<char>('a' + i % 26), static_cast<char>('a' + i / 26)};
+
+        ASSERT_EQ(i < 600 ? i : 600, many::find(std::string(name, 2)));
+        ASSERT_EQ(600, many::find(std::string(name, 1)));
+    }
+    ASSERT_EQ(600, many::find(std::string("aaa")));
+}
+
+#ifdef USE_CPP_20_STRING_TEMPLATE_ARGS
+TEST(test_string_switch, string_template_args) {
+    using verbs = string_switch<"GET", "PUT", "POST", "DELETE">;
+
+    ASSERT_EQ("POST", verbs::visit(KeyVisitor{}, std::string_view("POST")));
+    ASSERT_EQ("DELETE", verbs::visit(KeyVisitor{}, std::string_view("DELETE")));
+
+    using keys = basic_string_switch<string_key<'G', 'E', 'T'>, string_key<'P', 'U', 'T'>,
+                                     string_key<'P', 'O', 'S', 'T'>,
+                                     string_key<'D', 'E', 'L', 'E', 'T', 'E'>>;
+
+    ASSERT_TRUE((std::is_same<verbs, keys>::value));
+}
+#endif
+
+} // namespace integral_switch
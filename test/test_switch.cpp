@@ -57,6 +57,129 @@ TEST(test_switch, visit_nothrow) {
     ASSERT_EQ(-1, switch_::visit_nothrow(visitor, 68, -1));
 }
 
+struct Fallback {
+    std::size_t *calls;
+
+    constexpr std::size_t operator()(std::size_t value) const {
+        return calls ? (++*calls, value * 10) : value * 10;
+    }
+};
+
+TEST(test_switch, visit_or) {
+
+    Visitor visitor;
+    std::size_t calls = 0;
+
+    ASSERT_EQ(32, switch_::visit_or(visitor, 32, Fallback{&calls}));
+    ASSERT_EQ(67, switch_::visit_or(visitor, 67, Fallback{&calls}));
+    ASSERT_EQ(0, calls);
+    ASSERT_EQ(680, switch_::visit_or(visitor, 68, Fallback{&calls}));
+    ASSERT_EQ(1, calls);
+}
+
+struct MixedVisitor {
+    constexpr int operator()(size_constant<0>) const { return 0; }
+    constexpr long operator()(size_constant<1>) const { return 1; }
+    constexpr short operator()(size_constant<2>) const { return 2; }
+};
+
+using mixed_switch = integral_switch<std::size_t, 0, 1, 2>;
+
+TEST(test_switch, visit_common) {
+
+    MixedVisitor visitor;
+
+    static_assert(std::is_same<long, mixed_switch::common_return_type<MixedVisitor>>::value, "");
+    ASSERT_EQ(1, mixed_switch::visit_common(visitor, 1));
+    ASSERT_EQ(2, mixed_switch::visit_common(visitor, 2));
+    ASSERT_THROW(mixed_switch::visit_common(visitor, 3), std::invalid_argument);
+    ASSERT_EQ(-1, mixed_switch::visit_nothrow(convert_result<long>(visitor), 3, -1));
+}
+
+struct zero_on_miss {
+    template <typename Ret, typename T> static constexpr Ret miss(T &&) { return 0; }
+};
+
+using zero_switch = integral_switch<std::size_t, 1, 2, 3>;
+
+template <> struct miss_policy<zero_switch> { using type = zero_on_miss; };
+
+TEST(test_switch, miss_policy) {
+
+    Visitor visitor;
+
+    ASSERT_EQ(67, switch_::visit<abort_on_miss>(visitor, 67));
+    ASSERT_DEATH(switch_::visit<abort_on_miss>(visitor, 68), "");
+    ASSERT_EQ(0, switch_::visit<zero_on_miss>(visitor, 68));
+    ASSERT_THROW(switch_::visit<throw_on_miss>(visitor, 68), std::invalid_argument);
+
+    ASSERT_EQ(3, zero_switch::visit(visitor, 3));
+    ASSERT_EQ(0, zero_switch::visit(visitor, 4));
+    ASSERT_THROW(zero_switch::visit<throw_on_miss>(visitor, 4), std::invalid_argument);
+}
+
+TEST(test_switch, visit_error_code) {
+
+    Visitor visitor;
+    std::error_code ec = std::make_error_code(std::errc::io_error);
+
+    ASSERT_EQ(32, switch_::visit(visitor, 32, ec));
+    ASSERT_FALSE(ec);
+    ASSERT_EQ(0, switch_::visit(visitor, 68, ec));
+    ASSERT_EQ(std::errc::invalid_argument, ec);
+}
+
+TEST(test_switch, visit_unchecked) {
+
+    Visitor visitor;
+
+    ASSERT_EQ(0, switch_::visit_unchecked(visitor, 0));
+    ASSERT_EQ(32, switch_::visit_unchecked(visitor, 32));
+    ASSERT_EQ(67, switch_::visit_unchecked(visitor, 67));
+#ifndef NDEBUG
+    ASSERT_DEATH(switch_::visit_unchecked(visitor, 68), "not a key");
+#endif
+}
+
+TEST(test_switch, outline) {
+
+    Visitor visitor;
+
+    ASSERT_EQ(0, switch_::visit(outline(visitor), 0));
+    ASSERT_EQ(67, switch_::visit(outline(visitor), 67));
+    ASSERT_THROW(switch_::visit(outline(visitor), 68), std::invalid_argument);
+
+    ASSERT_EQ(32, switch_::visit_nothrow(outline<size_constant<32>>(visitor), 32, -1));
+    ASSERT_EQ(33, switch_::visit_nothrow(outline<size_constant<32>>(Visitor{}), 33, -1));
+    ASSERT_EQ(-1, switch_::visit_nothrow(outline<size_constant<32>>(visitor), 68, -1));
+}
+
+// Scales every element by the key.
+struct Scale {
+    template <std::size_t I> void operator()(size_constant<I>, int *data, std::size_t n) const {
+        for (std::size_t i = 0; i < n; ++i) {
+            data[i] *= static_cast<int>(I);
+        }
+    }
+};
+
+TEST(test_switch, resolve) {
+
+    int data[] = {1, 2, 3};
+
+    void (*scale)(int *, std::size_t) = switch_::resolve<void(int *, std::size_t), Scale>(3);
+
+    ASSERT_EQ(scale, (switch_::resolve<void(int *, std::size_t), Scale>(3)));
+    ASSERT_NE(scale, (switch_::resolve<void(int *, std::size_t), Scale>(4)));
+
+    scale(data, 3);
+    ASSERT_EQ(3, data[0]);
+    ASSERT_EQ(9, data[2]);
+
+    ASSERT_THROW((switch_::resolve<void(int *, std::size_t), Scale>(68)), std::invalid_argument);
+    ASSERT_EQ(nullptr, (switch_::resolve<void(int *, std::size_t), Scale, zero_on_miss>(68)));
+}
+
 template <std::size_t I> constexpr int visit(size_constant<I>) { return I; }
 
 #if __cpp_generic_lambdas
@@ -88,6 +211,9 @@ TEST(test_switch, staticassert) {
     static_assert(switch_::visit_nothrow(visitor, 64, -1) == static_cast<std::size_t>(64), "");
     static_assert(switch_::visit_nothrow(visitor, 67, -1) == static_cast<std::size_t>(67), "");
     static_assert(switch_::visit_nothrow(visitor, 68, -1) == static_cast<std::size_t>(-1), "");
+    static_assert(switch_::visit_unchecked(visitor, 67) == static_cast<std::size_t>(67), "");
+    static_assert(switch_::visit_or(visitor, 67, Fallback{nullptr}) == 67, "");
+    static_assert(switch_::visit_or(visitor, 68, Fallback{nullptr}) == 680, "");
 }
 #endif
 
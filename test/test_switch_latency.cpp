@@ -0,0 +1,89 @@
+/*
+ * test_switch_latency.cpp
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "switch_latency.h"
+
+namespace integral_switch {
+
+TEST(test_switch_latency, buckets) {
+    using detail::latency_bucket;
+    using detail::latency_bucket_max;
+
+    for (std::uint64_t ns : {0, 1, 15, 16, 17, 31, 32, 33, 1000, 123456, 999999999}) {
+        const std::size_t bucket = latency_bucket(ns);
+
+        ASSERT_LE(ns, latency_bucket_max(bucket));
+        ASSERT_TRUE(bucket == 0 || latency_bucket_max(bucket - 1) < ns);
+        // The relative error is at most 1/16.
+        ASSERT_LE(latency_bucket_max(bucket) - ns, ns / 16);
+    }
+
+    ASSERT_EQ(detail::latency_buckets - 1, latency_bucket(std::uint64_t(1) << 40));
+}
+
+using switch_ = integral_switch<int, 1, 2>;
+using latency_ = switch_latency<switch_>;
+
+struct Visitor {
+    void operator()(std::integral_constant<int, 1>) const {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    void operator()(std::integral_constant<int, 2>) const {}
+};
+
+TEST(test_switch_latency, visit_timed) {
+    latency_::reset();
+    latency_::set_sample_interval(1);
+
+    for (int i = 0; i < 5; ++i) {
+        visit_timed<switch_>(Visitor{}, 1);
+        visit_timed<switch_>(Visitor{}, 2);
+    }
+    ASSERT_THROW(visit_timed<switch_>(Visitor{}, 3), std::invalid_argument);
+
+    const auto summary = latency_::summary();
+
+    ASSERT_EQ(2, summary.size());
+    ASSERT_EQ(1, summary[0].key);
+    ASSERT_EQ(5, summary[0].samples);
+    ASSERT_GE(summary[0].p50, 2000000);
+    ASSERT_GE(summary[0].p999, summary[0].p99);
+    ASSERT_GE(summary[0].p99, summary[0].p50);
+    ASSERT_EQ(2, summary[1].key);
+    ASSERT_EQ(5, summary[1].samples);
+    ASSERT_LT(summary[1].p50, 2000000);
+}
+
+TEST(test_switch_latency, sampling) {
+    latency_::reset();
+    latency_::set_sample_interval(4);
+
+    for (int i = 0; i < 100; ++i) {
+        visit_timed<switch_>(Visitor{}, 2);
+    }
+
+    ASSERT_EQ(25, latency_::summary()[1].samples);
+    ASSERT_EQ(0, latency_::summary()[0].samples);
+}
+
+} // namespace integral_switch
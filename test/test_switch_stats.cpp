@@ -0,0 +1,88 @@
+/*
+ * test_switch_stats.cpp
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "switch_stats.h"
+
+namespace integral_switch {
+
+using switch_ = integral_switch<int, 7, 3, 40>;
+using stats_ = switch_stats<switch_>;
+
+struct Visitor {
+    template <int I> int operator()(std::integral_constant<int, I>) const { return I; }
+};
+
+TEST(test_switch_stats, visit_counted) {
+    stats_::reset();
+
+    ASSERT_EQ(7, visit_counted<switch_>(Visitor{}, 7));
+    ASSERT_EQ(40, visit_counted<switch_>(Visitor{}, 40));
+    ASSERT_EQ(40, visit_counted<switch_>(Visitor{}, 40));
+    ASSERT_THROW(visit_counted<switch_>(Visitor{}, 8), std::invalid_argument);
+    ASSERT_EQ(3, switch_::visit<count_on_miss<switch_>>(count_hits<switch_>(Visitor{}), 3));
+
+    const auto counts = stats_::snapshot();
+
+    ASSERT_EQ(3, counts.size());
+    ASSERT_EQ(std::make_pair(7, std::uint64_t(1)), counts[0]);
+    ASSERT_EQ(std::make_pair(3, std::uint64_t(1)), counts[1]);
+    ASSERT_EQ(std::make_pair(40, std::uint64_t(2)), counts[2]);
+    ASSERT_EQ(1, stats_::misses());
+
+    // Plain visits are not counted.
+    switch_::visit(Visitor{}, 7);
+    ASSERT_EQ(1, stats_::snapshot()[0].second);
+
+    stats_::reset();
+    ASSERT_EQ(0, stats_::snapshot()[2].second);
+    ASSERT_EQ(0, stats_::misses());
+}
+
+TEST(test_switch_stats, threads) {
+    stats_::reset();
+
+    // More threads than blocks: blocks are handed over when a thread exits, and threads that find
+    // no free block share the last one.
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < INTEGRAL_SWITCH_STATS_THREADS + 8; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 1000; ++i) {
+                visit_counted<switch_>(Visitor{}, 3);
+                visit_counted<switch_>(Visitor{}, 40);
+                switch_::visit<count_on_miss<switch_, abort_on_miss>>(Visitor{}, 40);
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    const auto counts = stats_::snapshot();
+
+    ASSERT_EQ(0, counts[0].second);
+    ASSERT_EQ(1000 * (INTEGRAL_SWITCH_STATS_THREADS + 8), counts[1].second);
+    ASSERT_EQ(1000 * (INTEGRAL_SWITCH_STATS_THREADS + 8), counts[2].second);
+}
+
+} // namespace integral_switch
@@ -0,0 +1,135 @@
+/*
+ * test_table_switch.cpp
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <type_traits>
+
+#include "integral_switch.h"
+
+namespace integral_switch {
+
+template <std::size_t I> using size_constant = std::integral_constant<std::size_t, I>;
+
+struct Visitor {
+    template <std::size_t I> constexpr std::size_t operator()(size_constant<I>) const { return I; }
+};
+
+template <typename> struct MakeSparseSwitch;
+
+template <std::size_t... Is> struct MakeSparseSwitch<detail::index_sequence<Is...>> {
+    using type = integral_switch<std::size_t, (3 * Is + 1)...>;
+};
+
+using dense_switch = make_integral_switch<detail::make_index_sequence<10000>>;
+using sparse_switch = MakeSparseSwitch<detail::make_index_sequence<3000>>::type;
+
+static_assert(std::is_same<detail::switch_impl_t<std::size_t, 0, 1, 2>,
+                           detail::integral_switch_impl<size_constant<0>, size_constant<1>,
+                                                        size_constant<2>>>::value,
+              "small switches use the generated switch statements");
+
+TEST(test_table_switch, dense) {
+    Visitor visitor;
+
+    ASSERT_EQ(0, dense_switch::visit(visitor, 0));
+    ASSERT_EQ(4321, dense_switch::visit(visitor, 4321));
+    ASSERT_EQ(9999, dense_switch::visit(visitor, 9999));
+    ASSERT_THROW(dense_switch::visit(visitor, 10000), std::invalid_argument);
+
+    ASSERT_EQ(9999, dense_switch::visit_nothrow(visitor, 9999, -1));
+    ASSERT_EQ(-1, dense_switch::visit_nothrow(visitor, 10000, -1));
+}
+
+TEST(test_table_switch, sparse) {
+    Visitor visitor;
+
+    ASSERT_EQ(1, sparse_switch::visit(visitor, 1));
+    ASSERT_EQ(4501, sparse_switch::visit(visitor, 4501));
+    ASSERT_EQ(8998, sparse_switch::visit(visitor, 8998));
+    ASSERT_THROW(sparse_switch::visit(visitor, 0), std::invalid_argument);
+    ASSERT_THROW(sparse_switch::visit(visitor, 4500), std::invalid_argument);
+    ASSERT_THROW(sparse_switch::visit(visitor, 9001), std::invalid_argument);
+
+    ASSERT_EQ(-1, sparse_switch::visit_nothrow(visitor, 2, -1));
+    ASSERT_EQ(4501, sparse_switch::visit_unchecked(visitor, 4501));
+}
+
+enum class Opcode : short { first = -300, last = 299 };
+
+template <typename> struct MakeOpcodeSwitch;
+
+template <std::size_t... Is> struct MakeOpcodeSwitch<detail::index_sequence<Is...>> {
+    using type = integral_switch<Opcode, static_cast<Opcode>(static_cast<int>(Is) - 300)...>;
+};
+
+using opcode_switch = MakeOpcodeSwitch<detail::make_index_sequence<600>>::type;
+
+struct OpcodeVisitor {
+    template <Opcode op> constexpr int operator()(std::integral_constant<Opcode, op>) const {
+        return static_cast<int>(op);
+    }
+};
+
+TEST(test_table_switch, enum_keys) {
+    OpcodeVisitor visitor;
+
+    ASSERT_EQ(-300, opcode_switch::visit(visitor, Opcode::first));
+    ASSERT_EQ(299, opcode_switch::visit(visitor, Opcode::last));
+    ASSERT_EQ(-1000, opcode_switch::visit_nothrow(visitor, static_cast<Opcode>(300), -1000));
+    ASSERT_EQ(-1000, opcode_switch::visit_nothrow(visitor, static_cast<Opcode>(-301), -1000));
+}
+
+template <typename> struct MakeShortSwitch;
+
+template <std::size_t... Is> struct MakeShortSwitch<detail::index_sequence<Is...>> {
+    using type = integral_switch<std::uint16_t, static_cast<std::uint16_t>(Is)...>;
+};
+
+using short_switch = MakeShortSwitch<detail::make_index_sequence<300>>::type;
+
+struct ShortVisitor {
+    template <std::uint16_t I>
+    constexpr int operator()(std::integral_constant<std::uint16_t, I>) const {
+        return I;
+    }
+};
+
+TEST(test_table_switch, values_wider_than_keys) {
+    ShortVisitor visitor;
+
+    ASSERT_EQ(5, short_switch::visit_nothrow(visitor, 5, -1));
+    ASSERT_EQ(-1, short_switch::visit_nothrow(visitor, 65541, -1));
+    ASSERT_EQ(-1, short_switch::visit_nothrow(visitor, -65531, -1));
+    ASSERT_EQ(-1, short_switch::visit_nothrow(visitor, -1, -1));
+    ASSERT_EQ(-1, short_switch::visit_nothrow(visitor, std::uint64_t(1) << 32, -1));
+    ASSERT_THROW(short_switch::visit(visitor, 65536 + 299), std::invalid_argument);
+}
+
+#ifdef USE_CPP_14_CONSTEXPR
+TEST(test_table_switch, staticassert) {
+    Visitor visitor;
+    static_assert(dense_switch::visit_nothrow(visitor, 5000, -1) == 5000, "");
+    static_assert(dense_switch::visit_nothrow(visitor, 10000, -1) == static_cast<std::size_t>(-1),
+                  "");
+    static_assert(sparse_switch::visit_nothrow(visitor, 7, -1) == 7, "");
+    static_assert(sparse_switch::visit_nothrow(visitor, 8, -1) == static_cast<std::size_t>(-1), "");
+}
+#endif
+
+} // namespace integral_switch
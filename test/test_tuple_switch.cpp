@@ -0,0 +1,122 @@
+/*
+ * test_tuple_switch.cpp
+ * Copyright (C) 2019  Qian Yu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <array>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "tuple_switch.h"
+
+namespace integral_switch {
+
+// Appends a field to the state of a column.
+struct Append {
+    const std::string &field;
+
+    void operator()(long &sum) const { sum += std::stol(field); }
+    void operator()(std::string &text) const { text += field; }
+    void operator()(std::vector<double> &values) const { values.push_back(std::stod(field)); }
+};
+
+struct Address {
+    const void *operator()(const long &x) const { return &x; }
+    const void *operator()(const std::string &x) const { return &x; }
+    const void *operator()(const std::vector<double> &x) const { return &x; }
+};
+
+TEST(test_tuple_switch, visit_tuple_at) {
+    std::tuple<long, std::string, std::vector<double>> columns;
+
+    visit_tuple_at(columns, 0, Append{"40"});
+    visit_tuple_at(columns, 0, Append{"2"});
+    visit_tuple_at(columns, 1, Append{"ab"});
+    visit_tuple_at(columns, 2, Append{"0.5"});
+
+    ASSERT_EQ(42, std::get<0>(columns));
+    ASSERT_EQ("ab", std::get<1>(columns));
+    ASSERT_EQ(std::vector<double>{0.5}, std::get<2>(columns));
+
+    // The elements are passed by reference.
+    const auto &const_columns = columns;
+
+    ASSERT_EQ(&std::get<1>(columns), visit_tuple_at(const_columns, 1, Address{}));
+
+    ASSERT_THROW(visit_tuple_at(columns, 3, Append{"1"}), std::invalid_argument);
+}
+
+struct Take {
+    std::unique_ptr<int> operator()(std::unique_ptr<int> &&p) const { return std::move(p); }
+};
+
+TEST(test_tuple_switch, rvalue_tuple) {
+    std::tuple<std::unique_ptr<int>, std::unique_ptr<int>> pointers(
+        std::unique_ptr<int>(new int(1)), std::unique_ptr<int>(new int(2)));
+
+    ASSERT_EQ(2, *visit_tuple_at(std::move(pointers), 1, Take{}));
+    ASSERT_NE(nullptr, std::get<0>(pointers));
+    ASSERT_EQ(nullptr, std::get<1>(pointers));
+}
+
+struct Double {
+    void operator()(int &x) const { x *= 2; }
+};
+
+TEST(test_tuple_switch, for_each_tuple_index) {
+    std::array<int, 4> values{{1, 2, 3, 4}};
+
+    for_each_tuple_index(values, std::vector<int>{3, 0, 3}, Double{});
+
+    ASSERT_EQ((std::array<int, 4>{{2, 2, 3, 16}}), values);
+    ASSERT_THROW(for_each_tuple_index(values, std::vector<int>{4}, Double{}),
+                 std::invalid_argument);
+
+    std::pair<int, int> pair(5, 6);
+
+    for_each_tuple_index(pair, std::array<std::size_t, 1>{{1}}, Double{});
+    ASSERT_EQ(12, pair.second);
+}
+
+struct Get {
+    int operator()(int x) const { return x; }
+};
+
+struct ignore_miss {
+    template <typename Ret, typename T> static Ret miss(T &&) { return Ret(); }
+};
+
+template <> struct miss_policy<make_integral_switch<detail::make_index_sequence<5>>> {
+    using type = ignore_miss;
+};
+
+TEST(test_tuple_switch, miss_policy) {
+    const std::array<int, 5> values{{1, 2, 3, 4, 5}};
+
+    ASSERT_EQ(5, visit_tuple_at(values, 4, Get{}));
+    ASSERT_EQ(0, visit_tuple_at(values, 5, Get{}));
+    ASSERT_THROW(visit_tuple_at<throw_on_miss>(values, 5, Get{}), std::invalid_argument);
+
+    std::array<int, 5> doubled{{1, 2, 3, 4, 5}};
+
+    for_each_tuple_index(doubled, std::vector<int>{0, 7, 4}, Double{});
+    ASSERT_EQ((std::array<int, 5>{{2, 2, 3, 4, 10}}), doubled);
+}
+
+} // namespace integral_switch